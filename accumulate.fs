@@ -0,0 +1,22 @@
+#version 330 core
+
+in vec2 fragTexCoord;
+out vec4 fragColor;
+
+// Moyenne progressive par pixel, en RGBA32F : alpha = nombre de frames où le pixel a été
+// échantillonné (les budgets fractionnaires de raytest.fs en sautent)
+//   avg_n = avg_(n-1) + (x_n - avg_(n-1)) / n
+uniform sampler2D texture0;       // moyenne des frames précédentes
+uniform sampler2D currentFrame;   // radiance linéaire de la frame (G-buffer, alpha 0 = pas d'échantillon)
+uniform int firstFrame;           // 1 après une remise à zéro : la cible précédente n'est pas lue
+
+void main() {
+    vec4 average = (firstFrame != 0) ? vec4(0.0) : texture(texture0, fragTexCoord);
+    vec4 current = texture(currentFrame, fragTexCoord);
+    if (current.a <= 0.0) {
+        fragColor = average;
+        return;
+    }
+    float count = average.a + 1.0;
+    fragColor = vec4(mix(average.rgb, current.rgb, 1.0 / count), count);
+}
@@ -0,0 +1,65 @@
+#include "accumulator.h"
+#include "rlgl.h"
+#include <string.h>
+
+bool loadAccumulator(Accumulator *accumulator, Shader shader, RenderPool *pool, GpuTimer *timer) {
+    accumulator->shader = shader;
+    accumulator->frameCount = 0;
+    accumulator->seed = 0;
+    accumulator->resets = 0;
+    memset(&accumulator->key, 0, sizeof(accumulator->key));
+    accumulator->pass = addGpuPass(timer, "accumulate");
+    accumulator->currentLoc = GetShaderLocation(shader, "currentFrame");
+    accumulator->firstFrameLoc = GetShaderLocation(shader, "firstFrame");
+
+    accumulator->targets[0] = addRenderTarget(pool, "accum_a", RENDER_TARGET_RGBA32F, TEXTURE_FILTER_BILINEAR);
+    accumulator->targets[1] = addRenderTarget(pool, "accum_b", RENDER_TARGET_RGBA32F, TEXTURE_FILTER_BILINEAR);
+    return accumulator->targets[0] >= 0 && accumulator->targets[1] >= 0;
+}
+
+void resetAccumulator(Accumulator *accumulator) {
+    accumulator->frameCount = 0;
+    accumulator->seed++;
+    accumulator->resets++;
+}
+
+static bool sameVector3(Vector3 a, Vector3 b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+bool updateAccumulator(Accumulator *accumulator, const AccumulationKey *key, bool sceneChanged) {
+    const AccumulationKey *last = &accumulator->key;
+    bool changed = sceneChanged
+                || !sameVector3(key->cameraPos, last->cameraPos) || !sameVector3(key->cameraTarget, last->cameraTarget)
+                || key->samplerType != last->samplerType || key->adaptiveThreshold != last->adaptiveThreshold
+                || key->samplesPerPixel != last->samplesPerPixel
+                || key->width != last->width || key->height != last->height;
+    accumulator->key = *key;
+    if (changed) resetAccumulator(accumulator);
+    return changed;
+}
+
+Texture2D accumulateFrame(Accumulator *accumulator, const RenderPool *pool, Texture2D frame, GpuTimer *timer) {
+    // frameCount pair : la moyenne précédente est dans targets[1], la nouvelle va dans targets[0]
+    RenderTexture2D previous = getRenderTarget(pool, accumulator->targets[(accumulator->frameCount + 1) % 2]);
+    RenderTexture2D output = getRenderTarget(pool, accumulator->targets[accumulator->frameCount % 2]);
+    int firstFrame = (accumulator->frameCount == 0) ? 1 : 0;
+
+    beginGpuPass(timer, accumulator->pass);
+    BeginTextureMode(output);
+        rlDisableColorBlend();
+        BeginShaderMode(accumulator->shader);
+            SetShaderValue(accumulator->shader, accumulator->firstFrameLoc, &firstFrame, SHADER_UNIFORM_INT);
+            SetShaderValueTexture(accumulator->shader, accumulator->currentLoc, frame);
+            // texture0 : moyenne précédente (ignorée à la première frame)
+            DrawTexturePro(previous.texture, (Rectangle){ 0.0f, 0.0f, (float)pool->width, -(float)pool->height },
+                           (Rectangle){ 0.0f, 0.0f, (float)pool->width, (float)pool->height }, (Vector2){ 0.0f, 0.0f },
+                           0.0f, WHITE);
+        EndShaderMode();
+        rlEnableColorBlend();
+    EndTextureMode();
+    endGpuPass(timer);
+
+    accumulator->frameCount++;
+    return output.texture;
+}
@@ -0,0 +1,46 @@
+#ifndef ACCUMULATOR_H
+#define ACCUMULATOR_H
+
+#include "raylib.h"
+#include "gpu_timer.h"
+#include "render_pool.h"
+
+// Accumulation progressive : moyenne exacte (poids 1/n) de toutes les frames rendues
+// depuis le dernier changement, dans deux cibles RGBA32F alternées ; n est compté par
+// pixel (alpha) car les budgets fractionnaires ne tracent pas tous les pixels.
+// Tant que rien ne bouge, raytest.fs poursuit la même suite d'échantillons (graine
+// fixe, indices décalés de frameCount * échantillons par frame) au lieu de la retirer.
+
+// Tout ce qui change l'image en dehors des envois de scène (SceneUploader)
+typedef struct {
+    Vector3 cameraPos;
+    Vector3 cameraTarget;
+    int samplerType;
+    float adaptiveThreshold;
+    float samplesPerPixel;
+    int width, height;
+} AccumulationKey;
+
+typedef struct {
+    Shader shader;
+    int targets[2];         // cibles du RenderPool
+    int frameCount;         // frames dans la moyenne (0 après une remise à zéro)
+    int seed;               // graine des tirages, changée à chaque remise à zéro
+    int resets;
+    AccumulationKey key;
+    int pass;               // passe GpuTimer
+    int currentLoc, firstFrameLoc;
+} Accumulator;
+
+bool loadAccumulator(Accumulator *accumulator, Shader shader, RenderPool *pool, GpuTimer *timer);
+
+void resetAccumulator(Accumulator *accumulator);
+// Remet à zéro si la clé diffère de celle de la frame précédente ou si la scène a été
+// renvoyée ; retourne true en cas de remise à zéro
+bool updateAccumulator(Accumulator *accumulator, const AccumulationKey *key, bool sceneChanged);
+
+// Ajoute la frame à la moyenne et renvoie la moyenne, alpha = frames échantillonnées
+// du pixel (valide jusqu'au prochain appel)
+Texture2D accumulateFrame(Accumulator *accumulator, const RenderPool *pool, Texture2D frame, GpuTimer *timer);
+
+#endif // ACCUMULATOR_H
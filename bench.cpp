@@ -0,0 +1,331 @@
+// Banc d'essai déterministe du traceur CPU : rend un jeu fixe de scènes (la pièce de
+// main.cpp, beaucoup de sphères, beaucoup de verre) sur plusieurs frames accumulées,
+// avec des graines fixes, et mesure le débit et la qualité par rapport à une
+// référence à fort nombre d'échantillons stockée dans bench/.
+//
+// Utilisation : ./tracer_bench [--frames n] [-s echantillons] [-t threads] [--scene nom]
+//                              [--simd auto|avx2|sse|scalar|off] [--wavefront] [--csv resultats.csv]
+//                              [--update-references]
+//
+// Les images ne dépendent que des réglages (time = 0, échantillonneur Sobol) : deux
+// exécutions donnent les mêmes RMSE, seuls les temps varient.
+#include "cpu_tracer.h"
+#include "raymath.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#define BENCH_WIDTH 160
+#define BENCH_HEIGHT 90
+#define BENCH_FRAMES 64
+#define BENCH_SAMPLES 4                 // échantillons par pixel et par frame
+#define BENCH_REFERENCE_SAMPLES 1024
+#define BENCH_REFERENCE_CHUNK 64        // échantillons par passe pendant la génération des références
+#define BENCH_QUALITY_RMSE 0.05         // seuil du temps jusqu'à la qualité
+#define BENCH_REFERENCE_DIR "bench/"
+
+typedef struct {
+    const char *name;
+    const char *description;
+    bool (*build)(SceneSoA *scene);
+} BenchScene;
+
+// Copie des murs de scene.h dans une scène déjà allouée
+static void copyRoomBlocks(SceneSoA *scene) {
+    for (int i = 0; i < MAX_BLOCKS; i++) {
+        scene->blockX[i] = blocks[i].position.x;
+        scene->blockY[i] = blocks[i].position.y;
+        scene->blockZ[i] = blocks[i].position.z;
+        scene->blockSizeX[i] = blocks[i].size.x;
+        scene->blockSizeY[i] = blocks[i].size.y;
+        scene->blockSizeZ[i] = blocks[i].size.z;
+        setMaterial(&scene->blockMaterials, i, materials_block[i]);
+    }
+}
+
+static void setSphere(SceneSoA *scene, int i, Vector3 position, float radius, Material2 material) {
+    scene->sphereX[i] = position.x;
+    scene->sphereY[i] = position.y;
+    scene->sphereZ[i] = position.z;
+    scene->sphereRadius[i] = radius;
+    setMaterial(&scene->sphereMaterials, i, material);
+}
+
+// Sphères de la pièce (miroir central et lumière) en tête de scène
+static void copyRoomSpheres(SceneSoA *scene) {
+    for (int i = 0; i < MAX_SPHERES; i++) setSphere(scene, i, spheres[i].position, spheres[i].radius, materials[i]);
+}
+
+// Générateur congruentiel fixe : mêmes couleurs à chaque exécution
+static float nextRandom(unsigned int *state) {
+    *state = *state * 1664525u + 1013904223u;
+    return (float)(*state >> 8) / 16777216.0f;
+}
+
+static bool buildRoomScene(SceneSoA *scene) {
+    return loadSceneSoAFromArrays(scene, spheres, materials, MAX_SPHERES, blocks, materials_block, MAX_BLOCKS);
+}
+
+// 8 x 8 petites sphères posées au sol derrière la sphère miroir
+static bool buildSpheresScene(SceneSoA *scene) {
+    const int grid = 8;
+    if (!loadSceneSoA(scene, MAX_SPHERES + grid*grid, MAX_BLOCKS, 0)) return false;
+    copyRoomBlocks(scene);
+    copyRoomSpheres(scene);
+
+    unsigned int state = 12345u;
+    for (int i = 0; i < grid*grid; i++) {
+        Material2 mat = { MAT_DIFFUSE, 0.0f, 1.0f, 0.0f, { 0.0f, 0.0f, 0.0f }, 0.0f };
+        mat.albedo.x = 0.2f + 0.7f * nextRandom(&state);
+        mat.albedo.y = 0.2f + 0.7f * nextRandom(&state);
+        mat.albedo.z = 0.2f + 0.7f * nextRandom(&state);
+        if (i % 3 == 1) { mat.type = MAT_METALLIC; mat.roughness = 0.2f; }
+        else if (i % 3 == 2) { mat.type = MAT_MIRROR; }
+
+        Vector3 position = { -3.5f + (float)(i % grid), -0.65f, -2.0f - (float)(i / grid) };
+        setSphere(scene, MAX_SPHERES + i, position, 0.3f, mat);
+    }
+    return true;
+}
+
+// 4 x 4 sphères de verre de rugosité et d'indice variables
+static bool buildGlassScene(SceneSoA *scene) {
+    const int grid = 4;
+    if (!loadSceneSoA(scene, MAX_SPHERES + grid*grid, MAX_BLOCKS, 0)) return false;
+    copyRoomBlocks(scene);
+    copyRoomSpheres(scene);
+
+    for (int i = 0; i < grid*grid; i++) {
+        Material2 mat = { MAT_GLASS, 0.1f * (float)(i % grid), 1.3f + 0.1f * (float)(i / grid), 0.0f, { 0.9f, 0.9f, 0.9f }, 0.0f };
+        Vector3 position = { -2.25f + 1.5f * (float)(i % grid), -0.5f, -1.5f - 1.5f * (float)(i / grid) };
+        setSphere(scene, MAX_SPHERES + i, position, 0.45f, mat);
+    }
+    return true;
+}
+
+static const BenchScene benchScenes[] = {
+    { "room", "piece de main.cpp (miroir + lumiere)", buildRoomScene },
+    { "spheres64", "64 spheres diffuses / metal / miroir", buildSpheresScene },
+    { "glass16", "16 spheres de verre rugueux", buildGlassScene },
+};
+static const int benchSceneCount = (int)(sizeof(benchScenes) / sizeof(benchScenes[0]));
+
+// Lecture d'un PPM binaire 8 bits (P6) écrit par saveFramebufferPPM
+static bool loadPPM(const char *fileName, std::vector<unsigned char> *pixels, int width, int height) {
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) return false;
+
+    int w = 0, h = 0, maxValue = 0;
+    bool ok = fscanf(file, "P6 %d %d %d", &w, &h, &maxValue) == 3 && fgetc(file) != EOF
+              && w == width && h == height && maxValue == 255;
+    if (ok) {
+        pixels->resize(3*width*height);
+        ok = fread(pixels->data(), 1, pixels->size(), file) == pixels->size();
+    }
+    fclose(file);
+    return ok;
+}
+
+// RMSE dans l'espace affiché (tone mapping de toneMapPixel, valeurs dans [0,1])
+static double displayRMSE(const float *framebuffer, const std::vector<unsigned char> &reference, int width, int height) {
+    double sum = 0.0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const float *p = framebuffer + 3*(y*width + x);
+            Vector3 c = toneMapPixel((Vector3){ p[0], p[1], p[2] }, x, y, width, height);
+            const unsigned char *r = &reference[3*(y*width + x)];
+            double dx = Clamp(c.x, 0.0f, 1.0f) - r[0] / 255.0;
+            double dy = Clamp(c.y, 0.0f, 1.0f) - r[1] / 255.0;
+            double dz = Clamp(c.z, 0.0f, 1.0f) - r[2] / 255.0;
+            sum += dx*dx + dy*dy + dz*dz;
+        }
+    }
+    return sqrt(sum / (3.0 * width * height));
+}
+
+// Accumulation de frames de samplesPerFrame échantillons (indices d'échantillons consécutifs)
+static void accumulateFrame(float *mean, const float *frame, int pixelValues, int frameIndex) {
+    float weight = 1.0f / (float)(frameIndex + 1);
+    for (int i = 0; i < pixelValues; i++) mean[i] += (frame[i] - mean[i]) * weight;
+}
+
+static bool updateReference(const BenchScene *benchScene, const TracerScene *scene, TracerSettings settings) {
+    int pixelValues = 3*settings.width*settings.height;
+    std::vector<float> mean(pixelValues, 0.0f), frame(pixelValues);
+    settings.samples = BENCH_REFERENCE_CHUNK;
+
+    int chunks = BENCH_REFERENCE_SAMPLES / BENCH_REFERENCE_CHUNK;
+    for (int c = 0; c < chunks; c++) {
+        settings.sampleOffset = c * BENCH_REFERENCE_CHUNK;
+        renderCpu(scene, &settings, frame.data());
+        accumulateFrame(mean.data(), frame.data(), pixelValues, c);
+        printf("\r%s : %d / %d echantillons", benchScene->name, (c + 1) * BENCH_REFERENCE_CHUNK, BENCH_REFERENCE_SAMPLES);
+        fflush(stdout);
+    }
+    printf("\n");
+
+    char fileName[256];
+    snprintf(fileName, sizeof(fileName), BENCH_REFERENCE_DIR "%s.ppm", benchScene->name);
+    return saveFramebufferPPM(fileName, mean.data(), settings.width, settings.height);
+}
+
+typedef struct {
+    double msPerFrame;
+    double primaryMrays;    // millions de rayons caméra par seconde
+    double totalMrays;      // tous rayons (segments + ombres)
+    double pathLength;      // segments moyens par chemin
+    double rmse;            // après toutes les frames, -1 sans référence
+    double timeToQuality;   // ms cumulées jusqu'à rmse <= BENCH_QUALITY_RMSE, -1 si jamais atteint
+} BenchResult;
+
+static BenchResult runBenchmark(const BenchScene *benchScene, const TracerScene *scene, TracerSettings settings, int frames) {
+    int pixelValues = 3*settings.width*settings.height;
+    std::vector<float> mean(pixelValues, 0.0f), frame(pixelValues);
+
+    char fileName[256];
+    snprintf(fileName, sizeof(fileName), BENCH_REFERENCE_DIR "%s.ppm", benchScene->name);
+    std::vector<unsigned char> reference;
+    bool hasReference = loadPPM(fileName, &reference, settings.width, settings.height);
+
+    BenchResult result = { 0.0, 0.0, 0.0, 0.0, -1.0, -1.0 };
+    TracerStats total = { 0, 0, 0 };
+    double totalMs = 0.0;
+    for (int f = 0; f < frames; f++) {
+        settings.sampleOffset = f * settings.samples;
+        TracerStats stats;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        renderCpu(scene, &settings, frame.data(), NULL, &stats);
+        totalMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        total.primaryRays += stats.primaryRays;
+        total.extensionRays += stats.extensionRays;
+        total.shadowRays += stats.shadowRays;
+
+        // Hors chronométrage : accumulation et comparaison à la référence
+        accumulateFrame(mean.data(), frame.data(), pixelValues, f);
+        if (hasReference) {
+            result.rmse = displayRMSE(mean.data(), reference, settings.width, settings.height);
+            if (result.timeToQuality < 0.0 && result.rmse <= BENCH_QUALITY_RMSE) result.timeToQuality = totalMs;
+        }
+    }
+
+    double seconds = totalMs / 1000.0;
+    result.msPerFrame = totalMs / frames;
+    result.primaryMrays = total.primaryRays / seconds / 1e6;
+    result.totalMrays = (total.extensionRays + total.shadowRays) / seconds / 1e6;
+    result.pathLength = total.primaryRays > 0 ? (double)total.extensionRays / total.primaryRays : 0.0;
+    return result;
+}
+
+static void printUsage(const char *program) {
+    printf("Utilisation : %s [--frames n] [-s echantillons] [-t threads] [--scene nom]\n", program);
+    printf("                 [--simd auto|avx2|sse|scalar|off] [--wavefront] [--csv resultats.csv]\n");
+    printf("                 [--update-references]\n");
+    printf("Scenes :");
+    for (int i = 0; i < benchSceneCount; i++) printf(" %s", benchScenes[i].name);
+    printf("\n");
+}
+
+int main(int argc, char **argv) {
+    TracerSettings settings = defaultTracerSettings();
+    settings.width = BENCH_WIDTH;
+    settings.height = BENCH_HEIGHT;
+    settings.samples = BENCH_SAMPLES;
+    settings.time = 0.0f;
+    settings.samplerType = SAMPLER_SOBOL;
+
+    int frames = BENCH_FRAMES;
+    const char *sceneFilter = NULL;
+    const char *csvFile = NULL;
+    bool updateReferences = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (strcmp(arg, "--frames") == 0 && hasValue) frames = atoi(argv[++i]);
+        else if (strcmp(arg, "-s") == 0 && hasValue) settings.samples = atoi(argv[++i]);
+        else if (strcmp(arg, "-t") == 0 && hasValue) settings.threadCount = atoi(argv[++i]);
+        else if (strcmp(arg, "--scene") == 0 && hasValue) sceneFilter = argv[++i];
+        else if (strcmp(arg, "--csv") == 0 && hasValue) csvFile = argv[++i];
+        else if (strcmp(arg, "--wavefront") == 0) settings.wavefront = true;
+        else if (strcmp(arg, "--update-references") == 0) updateReferences = true;
+        else if (strcmp(arg, "--simd") == 0 && hasValue) {
+            const char *name = argv[++i];
+            settings.packetKernels = (strcmp(name, "off") == 0) ? NULL : findPacketKernels(name);
+            if (settings.packetKernels == NULL && strcmp(name, "off") != 0) {
+                fprintf(stderr, "Noyaux SIMD '%s' inconnus ou non supportes par ce processeur\n", name);
+                return 1;
+            }
+        }
+        else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (frames <= 0 || settings.samples <= 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    FILE *csv = NULL;
+    if (csvFile != NULL) {
+        csv = fopen(csvFile, "w");
+        if (csv == NULL) {
+            fprintf(stderr, "Impossible d'ecrire %s\n", csvFile);
+            return 1;
+        }
+        fprintf(csv, "scene,ms_per_frame,primary_mrays_s,total_mrays_s,path_length,rmse,time_to_quality_ms\n");
+    }
+
+    if (!updateReferences) {
+        printf("%dx%d, %d frames x %d echantillons, paquets %s%s\n", settings.width, settings.height, frames, settings.samples,
+               settings.packetKernels ? settings.packetKernels->name : "off", settings.wavefront ? ", wavefront" : "");
+        printf("%-10s %10s %12s %12s %9s %8s %14s\n", "scene", "ms/frame", "Mrays/s cam", "Mrays/s tot", "longueur", "RMSE", "t(RMSE<0.05)");
+    }
+
+    bool found = false;
+    for (int i = 0; i < benchSceneCount; i++) {
+        const BenchScene *benchScene = &benchScenes[i];
+        if (sceneFilter != NULL && strcmp(sceneFilter, benchScene->name) != 0) continue;
+        found = true;
+
+        SceneSoA soa;
+        if (!benchScene->build(&soa)) {
+            fprintf(stderr, "Allocation de la scene %s impossible\n", benchScene->name);
+            return 1;
+        }
+        Bvh bvh;
+        buildBvh(&bvh, &soa);
+        BvhView bvhView = makeBvhView(&bvh);
+        TracerScene scene = makeTracerScene(&soa, &bvhView);
+
+        if (updateReferences) {
+            if (!updateReference(benchScene, &scene, settings)) fprintf(stderr, "Impossible d'ecrire la reference de %s\n", benchScene->name);
+            unloadSceneSoA(&soa);
+            continue;
+        }
+
+        BenchResult r = runBenchmark(benchScene, &scene, settings, frames);
+        char rmse[32] = "-", quality[32] = "-";
+        if (r.rmse >= 0.0) snprintf(rmse, sizeof(rmse), "%.4f", r.rmse);
+        if (r.timeToQuality >= 0.0) snprintf(quality, sizeof(quality), "%.1f ms", r.timeToQuality);
+        printf("%-10s %10.1f %12.3f %12.3f %9.2f %8s %14s\n", benchScene->name, r.msPerFrame, r.primaryMrays, r.totalMrays,
+               r.pathLength, rmse, quality);
+        if (csv != NULL) {
+            fprintf(csv, "%s,%.3f,%.4f,%.4f,%.4f,%.5f,%.3f\n", benchScene->name, r.msPerFrame, r.primaryMrays, r.totalMrays,
+                    r.pathLength, r.rmse, r.timeToQuality);
+        }
+        unloadSceneSoA(&soa);
+    }
+
+    if (csv != NULL) fclose(csv);
+    if (!found) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,234 @@
+#include "bvh.h"
+#include "raymath.h"
+#include <math.h>
+#include <algorithm>
+
+// Primitive en cours de construction : boîte englobante, centroïde et référence finale
+typedef struct {
+    Vector3 boundsMin;
+    Vector3 boundsMax;
+    Vector3 centroid;
+    int ref;
+} BuildPrim;
+
+typedef struct {
+    Vector3 boundsMin;
+    Vector3 boundsMax;
+    int count;
+} BuildBin;
+
+static inline void emptyBounds(Vector3 *boundsMin, Vector3 *boundsMax) {
+    *boundsMin = (Vector3){ 1e30f, 1e30f, 1e30f };
+    *boundsMax = (Vector3){ -1e30f, -1e30f, -1e30f };
+}
+
+static inline void growBounds(Vector3 *boundsMin, Vector3 *boundsMax, Vector3 pMin, Vector3 pMax) {
+    *boundsMin = Vector3Min(*boundsMin, pMin);
+    *boundsMax = Vector3Max(*boundsMax, pMax);
+}
+
+static inline float surfaceArea(Vector3 boundsMin, Vector3 boundsMax) {
+    Vector3 d = boundsMax - boundsMin;
+    if (d.x < 0.0f || d.y < 0.0f || d.z < 0.0f) return 0.0f;
+    return 2.0f * (d.x*d.y + d.y*d.z + d.z*d.x);
+}
+
+static inline float axisOf(Vector3 v, int axis) {
+    return (axis == 0) ? v.x : ((axis == 1) ? v.y : v.z);
+}
+
+static inline int binIndex(float centroid, float cmin, float scale) {
+    int b = (int)((centroid - cmin) * scale);
+    if (b < 0) b = 0;
+    if (b > BVH_SAH_BINS - 1) b = BVH_SAH_BINS - 1;
+    return b;
+}
+
+static void makeLeaf(BvhNode *node, int first, int count) {
+    node->leftFirst = first;
+    node->count = count;
+}
+
+// Construction récursive : le noeud nodeIndex couvre prims[first .. first+count)
+static void subdivide(Bvh *bvh, std::vector<BuildPrim> &prims, int nodeIndex, int first, int count, int depth) {
+    Vector3 boundsMin, boundsMax, centroidMin, centroidMax;
+    emptyBounds(&boundsMin, &boundsMax);
+    emptyBounds(&centroidMin, &centroidMax);
+    for (int i = first; i < first + count; i++) {
+        growBounds(&boundsMin, &boundsMax, prims[i].boundsMin, prims[i].boundsMax);
+        growBounds(&centroidMin, &centroidMax, prims[i].centroid, prims[i].centroid);
+    }
+    bvh->nodes[nodeIndex].boundsMin = boundsMin;
+    bvh->nodes[nodeIndex].boundsMax = boundsMax;
+
+    // La profondeur est bornée pour que la pile de parcours ne déborde jamais
+    if (count == 1 || depth >= BVH_STACK_SIZE - 2) {
+        makeLeaf(&bvh->nodes[nodeIndex], first, count);
+        return;
+    }
+
+    // Recherche du meilleur plan de coupe par intervalles (binned SAH)
+    float bestCost = 1e30f;
+    int bestAxis = -1;
+    int bestSplit = 0;
+    for (int axis = 0; axis < 3; axis++) {
+        float cmin = axisOf(centroidMin, axis);
+        float cmax = axisOf(centroidMax, axis);
+        if (cmax - cmin < 1e-6f) continue;
+
+        BuildBin bins[BVH_SAH_BINS];
+        for (int b = 0; b < BVH_SAH_BINS; b++) {
+            emptyBounds(&bins[b].boundsMin, &bins[b].boundsMax);
+            bins[b].count = 0;
+        }
+        float scale = (float)BVH_SAH_BINS / (cmax - cmin);
+        for (int i = first; i < first + count; i++) {
+            BuildBin &bin = bins[binIndex(axisOf(prims[i].centroid, axis), cmin, scale)];
+            growBounds(&bin.boundsMin, &bin.boundsMax, prims[i].boundsMin, prims[i].boundsMax);
+            bin.count++;
+        }
+
+        // Balayage gauche -> droite puis droite -> gauche pour les aires cumulées
+        float leftArea[BVH_SAH_BINS - 1], rightArea[BVH_SAH_BINS - 1];
+        int leftCount[BVH_SAH_BINS - 1], rightCount[BVH_SAH_BINS - 1];
+        Vector3 leftMin, leftMax, rightMin, rightMax;
+        emptyBounds(&leftMin, &leftMax);
+        emptyBounds(&rightMin, &rightMax);
+        int leftSum = 0, rightSum = 0;
+        for (int b = 0; b < BVH_SAH_BINS - 1; b++) {
+            leftSum += bins[b].count;
+            leftCount[b] = leftSum;
+            growBounds(&leftMin, &leftMax, bins[b].boundsMin, bins[b].boundsMax);
+            leftArea[b] = surfaceArea(leftMin, leftMax);
+
+            rightSum += bins[BVH_SAH_BINS - 1 - b].count;
+            rightCount[BVH_SAH_BINS - 2 - b] = rightSum;
+            growBounds(&rightMin, &rightMax, bins[BVH_SAH_BINS - 1 - b].boundsMin, bins[BVH_SAH_BINS - 1 - b].boundsMax);
+            rightArea[BVH_SAH_BINS - 2 - b] = surfaceArea(rightMin, rightMax);
+        }
+
+        for (int b = 0; b < BVH_SAH_BINS - 1; b++) {
+            if (leftCount[b] == 0 || rightCount[b] == 0) continue;
+            float cost = leftArea[b] * (float)leftCount[b] + rightArea[b] * (float)rightCount[b];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = b;
+            }
+        }
+    }
+
+    // Coût SAH normalisé (traversée = 1, intersection = 1) comparé au coût d'une feuille
+    float parentArea = surfaceArea(boundsMin, boundsMax);
+    float splitCost = (parentArea > 0.0f) ? 1.0f + bestCost / parentArea : 1e30f;
+    if (count <= BVH_MAX_LEAF_SIZE && (bestAxis < 0 || splitCost >= (float)count)) {
+        makeLeaf(&bvh->nodes[nodeIndex], first, count);
+        return;
+    }
+
+    int mid;
+    if (bestAxis >= 0) {
+        float cmin = axisOf(centroidMin, bestAxis);
+        float scale = (float)BVH_SAH_BINS / (axisOf(centroidMax, bestAxis) - cmin);
+        BuildPrim *split = std::partition(prims.data() + first, prims.data() + first + count,
+            [&](const BuildPrim &p) { return binIndex(axisOf(p.centroid, bestAxis), cmin, scale) <= bestSplit; });
+        mid = (int)(split - prims.data());
+    } else {
+        // Centroïdes confondus : coupe au milieu de la liste
+        mid = first + count/2;
+    }
+
+    int leftIndex = (int)bvh->nodes.size();
+    BvhNode child = { 0 };
+    bvh->nodes.push_back(child);
+    bvh->nodes.push_back(child);
+    bvh->nodes[nodeIndex].leftFirst = leftIndex;
+    bvh->nodes[nodeIndex].count = 0;
+
+    subdivide(bvh, prims, leftIndex, first, mid - first, depth + 1);
+    subdivide(bvh, prims, leftIndex + 1, mid, first + count - mid, depth + 1);
+}
+
+void buildBvh(Bvh *bvh, const SceneSoA *scene) {
+    bvh->nodes.clear();
+    bvh->primRefs.clear();
+
+    std::vector<BuildPrim> prims;
+    prims.reserve(scene->sphereCount + scene->blockCount + scene->triangleCount);
+    for (int i = 0; i < scene->sphereCount; i++) {
+        BuildPrim p;
+        Vector3 center = { scene->sphereX[i], scene->sphereY[i], scene->sphereZ[i] };
+        Vector3 r = { scene->sphereRadius[i], scene->sphereRadius[i], scene->sphereRadius[i] };
+        p.boundsMin = center - r;
+        p.boundsMax = center + r;
+        p.centroid = center;
+        p.ref = makeBvhPrimRef(i, BVH_PRIM_SPHERE);
+        prims.push_back(p);
+    }
+    for (int i = 0; i < scene->blockCount; i++) {
+        BuildPrim p;
+        Vector3 position = { scene->blockX[i], scene->blockY[i], scene->blockZ[i] };
+        Vector3 halfSize = (Vector3){ scene->blockSizeX[i], scene->blockSizeY[i], scene->blockSizeZ[i] } * 0.5f;
+        p.boundsMin = position - halfSize;
+        p.boundsMax = position + halfSize;
+        p.centroid = position;
+        p.ref = makeBvhPrimRef(i, BVH_PRIM_BLOCK);
+        prims.push_back(p);
+    }
+    for (int i = 0; i < scene->triangleCount; i++) {
+        BuildPrim p;
+        Vector3 v0, v1, v2;
+        getTriangle(scene, i, &v0, &v1, &v2);
+        p.boundsMin = Vector3Min(v0, Vector3Min(v1, v2));
+        p.boundsMax = Vector3Max(v0, Vector3Max(v1, v2));
+        p.centroid = (v0 + v1 + v2) * (1.0f / 3.0f);
+        p.ref = makeBvhPrimRef(i, BVH_PRIM_TRIANGLE);
+        prims.push_back(p);
+    }
+
+    if (prims.empty()) return;
+
+    // Au plus 2N-1 noeuds
+    bvh->nodes.reserve(2*prims.size());
+    BvhNode root = { 0 };
+    bvh->nodes.push_back(root);
+    subdivide(bvh, prims, 0, 0, (int)prims.size(), 0);
+
+    bvh->primRefs.resize(prims.size());
+    for (size_t i = 0; i < prims.size(); i++) bvh->primRefs[i] = prims[i].ref;
+}
+
+float intersectBvhBounds(Vector3 ro, Vector3 invDir, Vector3 boundsMin, Vector3 boundsMax, float maxT) {
+    float tx1 = (boundsMin.x - ro.x) * invDir.x, tx2 = (boundsMax.x - ro.x) * invDir.x;
+    float tmin = fminf(tx1, tx2), tmax = fmaxf(tx1, tx2);
+    float ty1 = (boundsMin.y - ro.y) * invDir.y, ty2 = (boundsMax.y - ro.y) * invDir.y;
+    tmin = fmaxf(tmin, fminf(ty1, ty2)); tmax = fminf(tmax, fmaxf(ty1, ty2));
+    float tz1 = (boundsMin.z - ro.z) * invDir.z, tz2 = (boundsMax.z - ro.z) * invDir.z;
+    tmin = fmaxf(tmin, fminf(tz1, tz2)); tmax = fminf(tmax, fmaxf(tz1, tz2));
+    if (tmax >= tmin && tmin < maxT && tmax > 0.0f) return tmin;
+    return 1e30f;
+}
+
+void flattenBvhTexture(const BvhView *bvh, std::vector<float> *texels, int *width, int *height, int *primOffset) {
+    int nodeTexels = 2*bvh->nodeCount;
+    int totalTexels = nodeTexels + bvh->primRefCount;
+
+    *width = BVH_TEXTURE_WIDTH;
+    *height = (totalTexels + BVH_TEXTURE_WIDTH - 1) / BVH_TEXTURE_WIDTH;
+    if (*height < 1) *height = 1;
+    *primOffset = nodeTexels;
+
+    texels->assign(4*(*width)*(*height), 0.0f);
+    float *out = texels->data();
+    for (int i = 0; i < bvh->nodeCount; i++) {
+        const BvhNode &node = bvh->nodes[i];
+        out[0] = node.boundsMin.x; out[1] = node.boundsMin.y; out[2] = node.boundsMin.z; out[3] = (float)node.leftFirst;
+        out[4] = node.boundsMax.x; out[5] = node.boundsMax.y; out[6] = node.boundsMax.z; out[7] = (float)node.count;
+        out += 8;
+    }
+    for (int i = 0; i < bvh->primRefCount; i++) {
+        out[0] = (float)bvhPrimIndex(bvh->primRefs[i]);
+        out[1] = (float)bvhPrimType(bvh->primRefs[i]);
+        out += 4;
+    }
+}
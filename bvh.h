@@ -0,0 +1,64 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include "raylib.h"
+#include "scene_soa.h"
+#include <vector>
+
+// Hiérarchie de volumes englobants (BVH) construite avec l'heuristique de surface (SAH)
+// sur les sphères, les blocs et les triangles de la scène. Utilisée par le traceur CPU et aplatie
+// dans une texture RGBA32F parcourue avec une pile dans raytest.fs.
+
+#define BVH_PRIM_SPHERE 0
+#define BVH_PRIM_BLOCK 1
+#define BVH_PRIM_TRIANGLE 2
+
+#define BVH_MAX_LEAF_SIZE 4
+#define BVH_SAH_BINS 12
+#define BVH_STACK_SIZE 32       // profondeur de pile de parcours (CPU et shader)
+#define BVH_TEXTURE_WIDTH 1024  // doit rester identique à raytest.fs
+
+// Noeud de 32 octets : si count == 0, leftFirst est l'indice du fils gauche
+// (le fils droit suit immédiatement), sinon c'est le premier indice dans primRefs
+typedef struct {
+    Vector3 boundsMin;
+    int leftFirst;
+    Vector3 boundsMax;
+    int count;
+} BvhNode;
+
+typedef struct {
+    std::vector<BvhNode> nodes;
+    std::vector<int> primRefs;  // (index << 2) | type
+} Bvh;
+
+// Vue en lecture seule sur les tableaux d'un BVH : ceux d'un Bvh construit, ou les
+// sections d'un fichier de scène projeté (utilisées sur place, sans copie)
+typedef struct {
+    const BvhNode *nodes;
+    int nodeCount;
+    const int *primRefs;
+    int primRefCount;
+} BvhView;
+
+static inline BvhView makeBvhView(const Bvh *bvh) {
+    BvhView view = { bvh->nodes.data(), (int)bvh->nodes.size(), bvh->primRefs.data(), (int)bvh->primRefs.size() };
+    return view;
+}
+
+static inline int makeBvhPrimRef(int index, int type) { return (index << 2) | type; }
+static inline int bvhPrimType(int ref) { return ref & 3; }
+static inline int bvhPrimIndex(int ref) { return ref >> 2; }
+
+// Construction (remplace le contenu de bvh)
+void buildBvh(Bvh *bvh, const SceneSoA *scene);
+
+// Test rayon / boîte englobante, retourne la distance d'entrée ou 1e30 si pas d'intersection avant maxT
+float intersectBvhBounds(Vector3 ro, Vector3 invDir, Vector3 boundsMin, Vector3 boundsMax, float maxT);
+
+// Aplatissement pour le GPU : noeuds sur 2 texels (min.xyz, leftFirst) (max.xyz, count)
+// suivis des références de primitives, une par texel. Les entiers sont stockés en
+// flottants (exacts jusqu'à 2^24). *primOffset reçoit l'indice du premier texel de primitives.
+void flattenBvhTexture(const BvhView *bvh, std::vector<float> *texels, int *width, int *height, int *primOffset);
+
+#endif // BVH_H
@@ -0,0 +1,1340 @@
+#include "cpu_tracer.h"
+#include "raymath.h"
+#include "ray_packet.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <mutex>
+#include <vector>
+
+// Portage fidèle de raytest.fs : mêmes constantes, mêmes graines, même ordre des tests.
+// Les commentaires renvoient aux fonctions GLSL correspondantes.
+
+// Compteurs de rayons du thread courant, versés dans TracerStats à la fin de chaque tuile
+static thread_local TracerStats rayStats;
+
+// Conversion float -> uint façon GLSL (les valeurs négatives bouclent au lieu d'être indéfinies)
+static inline uint32_t toUint(float f) {
+    return (uint32_t)(int64_t)f;
+}
+
+static inline float fract(float x) {
+    return x - floorf(x);
+}
+
+static inline float signf(float x) {
+    return (x > 0.0f) ? 1.0f : ((x < 0.0f) ? -1.0f : 0.0f);
+}
+
+// Hash function pour générer des nombres pseudo-aléatoires
+static inline uint32_t hash(uint32_t x) {
+    x = x * 1664525u + 1013904223u;
+    x ^= x >> 16u;
+    x *= 0x3dba2d8du;
+    x ^= x >> 16u;
+    return x;
+}
+
+static inline float random(Vector3 pos, float seed) {
+    uint32_t h = hash(toUint(pos.x * 8192.0f) ^ hash(toUint(pos.y * 8192.0f) ^ hash(toUint(pos.z * 8192.0f) ^ hash(toUint(seed * 91.237f)))));
+    return (float)h / 4294967296.0f;
+}
+
+static inline Vector2 randomVec2(Vector3 pos, float seed) {
+    Vector2 r = { random(pos, seed), random(pos, seed + 1.618f) };
+    return r;
+}
+
+// Tirages d'une dimension du chemin : bruit blanc historique ou échantillonneur à faible
+// discrépance (pos et seed ne servent qu'au mode SAMPLER_HASH)
+static inline Vector2 sample2D(const PathSampler *sampler, int dimension, Vector3 pos, float seed) {
+    if (sampler->type == SAMPLER_HASH) return randomVec2(pos, seed);
+    return sampleLowDiscrepancy(sampler, dimension);
+}
+
+static inline float sample1D(const PathSampler *sampler, int dimension, Vector3 pos, float seed) {
+    if (sampler->type == SAMPLER_HASH) return random(pos, seed);
+    return sampleLowDiscrepancy(sampler, dimension).x;
+}
+
+// Base orthonormée alignée sur l'axe (équivalent du mat3 tbn du shader)
+static inline Vector3 toBasis(Vector3 axis, Vector3 dir) {
+    Vector3 up = fabsf(axis.z) < 0.999f ? (Vector3){ 0.0f, 0.0f, 1.0f } : (Vector3){ 1.0f, 0.0f, 0.0f };
+    Vector3 tangent = Vector3Normalize(Vector3CrossProduct(up, axis));
+    Vector3 bitangent = Vector3CrossProduct(axis, tangent);
+    return Vector3Normalize(tangent * dir.x + bitangent * dir.y + axis * dir.z);
+}
+
+// Échantillonnage cosinus pondéré pour une meilleure distribution
+static Vector3 sampleHemisphere(Vector3 normal, Vector3 pos, float seed, const PathSampler *sampler, int dimension) {
+    Vector2 rand = sample2D(sampler, dimension, pos, seed);
+
+    float phi = 2.0f * PI * rand.x;
+    float cosTheta = sqrtf(rand.y);  // Distribution en cosinus
+    float sinTheta = sqrtf(1.0f - cosTheta * cosTheta);
+
+    Vector3 dir = { cosf(phi) * sinTheta, sinf(phi) * sinTheta, cosTheta };
+    return toBasis(normal, dir);
+}
+
+// Réflexion spéculaire avec perturbation pour rugosité
+static Vector3 reflect_custom(Vector3 incident, Vector3 normal, float roughness, Vector3 pos, float seed, const PathSampler *sampler, int dimension) {
+    Vector3 reflected = Vector3Reflect(incident, normal);
+
+    if (roughness > 0.0f) {
+        Vector2 rand = sample2D(sampler, dimension, pos, seed);
+        float phi = 2.0f * PI * rand.x;
+        float cosTheta = powf(1.0f - rand.y * roughness * roughness, 1.0f / 3.0f);
+        float sinTheta = sqrtf(1.0f - cosTheta * cosTheta);
+
+        Vector3 scatter = { cosf(phi) * sinTheta, sinf(phi) * sinTheta, cosTheta };
+        return toBasis(reflected, scatter);
+    }
+
+    return reflected;
+}
+
+// Réfraction avec loi de Fresnel et perturbation pour rugosité
+static Vector3 refract(Vector3 incident, Vector3 normal, float ior, float roughness, Vector3 pos, float seed, const PathSampler *sampler, int bounce, float *reflectionChance) {
+    float eta = Vector3DotProduct(incident, normal) < 0.0f ? 1.0f / ior : ior;
+    Vector3 n = Vector3DotProduct(incident, normal) < 0.0f ? normal : Vector3Negate(normal);
+
+    float cosI = fabsf(Vector3DotProduct(incident, n));
+    float sinT2 = eta * eta * (1.0f - cosI * cosI);
+
+    // Réflexion totale interne
+    if (sinT2 > 1.0f) {
+        *reflectionChance = 1.0f;
+        return reflect_custom(incident, n, roughness, pos, seed, sampler, samplerBounceDim(bounce, SAMPLER_DIM_SCATTER));
+    }
+
+    float cosT = sqrtf(1.0f - sinT2);
+
+    // Approximation de Schlick pour Fresnel
+    float r0 = ((1.0f - eta) / (1.0f + eta)) * ((1.0f - eta) / (1.0f + eta));
+    float fresnel = r0 + (1.0f - r0) * powf(1.0f - cosI, 5.0f);
+
+    *reflectionChance = fresnel;
+
+    if (sample1D(sampler, samplerBounceDim(bounce, SAMPLER_DIM_FRESNEL), pos, seed + 4.269f) < fresnel) {
+        return reflect_custom(incident, n, roughness, pos, seed, sampler, samplerBounceDim(bounce, SAMPLER_DIM_SCATTER));
+    }
+
+    Vector3 refracted = Vector3Normalize(incident * eta + n * (eta * cosI - cosT));
+
+    if (roughness > 0.0f) {
+        Vector2 rand = sample2D(sampler, samplerBounceDim(bounce, SAMPLER_DIM_REFRACT), pos, seed + 2.718f);
+        float phi = 2.0f * PI * rand.x;
+        float cosTheta = powf(1.0f - rand.y * roughness * roughness, 1.0f / 2.0f);
+        float sinTheta = sqrtf(1.0f - cosTheta * cosTheta);
+
+        Vector3 scatter = { cosf(phi) * sinTheta, sinf(phi) * sinTheta, cosTheta };
+        return toBasis(refracted, scatter);
+    }
+
+    return refracted;
+}
+
+static bool intersectSphere(Vector3 ro, Vector3 rd, Vector3 center, float radius, float *t, Vector3 *n) {
+    Vector3 oc = ro - center;
+    float b = Vector3DotProduct(oc, rd);
+    float c = Vector3DotProduct(oc, oc) - radius * radius;
+    float h = b*b - c;
+
+    if (h < 0.0f) return false;
+
+    h = sqrtf(h);
+    *t = -b - h;
+
+    if (*t < 0.001f) *t = -b + h;
+    if (*t < 0.001f) return false;
+
+    Vector3 hit = ro + rd * (*t);
+    *n = Vector3Normalize(hit - center);
+
+    return true;
+}
+
+// Fonction d'intersection pour les boîtes alignées sur les axes (AABB)
+static bool intersectBox(Vector3 ro, Vector3 rd, Vector3 boxMin, Vector3 boxMax, float *t, Vector3 *n) {
+    Vector3 invDir = { 1.0f / rd.x, 1.0f / rd.y, 1.0f / rd.z };
+    Vector3 t0s = (boxMin - ro) * invDir;
+    Vector3 t1s = (boxMax - ro) * invDir;
+
+    Vector3 tsmaller = Vector3Min(t0s, t1s);
+    Vector3 tbigger = Vector3Max(t0s, t1s);
+
+    float tmin = fmaxf(fmaxf(tsmaller.x, tsmaller.y), tsmaller.z);
+    float tmax = fminf(fminf(tbigger.x, tbigger.y), tbigger.z);
+
+    if (tmin > tmax || tmax < 0.001f) return false;
+
+    *t = tmin > 0.001f ? tmin : tmax;
+    if (*t < 0.001f) return false;
+
+    // Calculer la normale
+    Vector3 hit = ro + rd * (*t);
+    Vector3 center = (boxMin + boxMax) * 0.5f;
+    Vector3 d = hit - center;
+    Vector3 halfSize = (boxMax - boxMin) * 0.5f;
+    d = (Vector3){ fabsf(d.x) - halfSize.x, fabsf(d.y) - halfSize.y, fabsf(d.z) - halfSize.z };
+
+    // Trouver la face la plus proche
+    if (d.x > d.y && d.x > d.z) {
+        *n = (Vector3){ signf(hit.x - center.x), 0.0f, 0.0f };
+    } else if (d.y > d.z) {
+        *n = (Vector3){ 0.0f, signf(hit.y - center.y), 0.0f };
+    } else {
+        *n = (Vector3){ 0.0f, 0.0f, signf(hit.z - center.z) };
+    }
+
+    return true;
+}
+
+// Möller-Trumbore, normale géométrique (v1 - v0) x (v2 - v0), non retournée vers le rayon
+// pour que le verre distingue l'entrée de la sortie comme avec les sphères
+static bool intersectTriangle(Vector3 ro, Vector3 rd, Vector3 v0, Vector3 v1, Vector3 v2, float *t, Vector3 *n) {
+    Vector3 e1 = v1 - v0;
+    Vector3 e2 = v2 - v0;
+    Vector3 p = Vector3CrossProduct(rd, e2);
+    float det = Vector3DotProduct(e1, p);
+    if (fabsf(det) < 1e-12f) return false;
+
+    float invDet = 1.0f / det;
+    Vector3 s = ro - v0;
+    float u = Vector3DotProduct(s, p) * invDet;
+    if (u < 0.0f || u > 1.0f) return false;
+    Vector3 q = Vector3CrossProduct(s, e1);
+    float v = Vector3DotProduct(rd, q) * invDet;
+    if (v < 0.0f || u + v > 1.0f) return false;
+
+    *t = Vector3DotProduct(e2, q) * invDet;
+    if (*t < 0.001f) return false;
+
+    *n = Vector3Normalize(Vector3CrossProduct(e1, e2));
+    return true;
+}
+
+static inline Vector3 sphereCenter(const SceneSoA *soa, int i) {
+    return (Vector3){ soa->sphereX[i], soa->sphereY[i], soa->sphereZ[i] };
+}
+
+static inline void blockBounds(const SceneSoA *soa, int i, Vector3 *blockMin, Vector3 *blockMax) {
+    Vector3 position = { soa->blockX[i], soa->blockY[i], soa->blockZ[i] };
+    Vector3 halfSize = (Vector3){ soa->blockSizeX[i], soa->blockSizeY[i], soa->blockSizeZ[i] } * 0.5f;
+    *blockMin = position - halfSize;
+    *blockMax = position + halfSize;
+}
+
+static inline void triangleVertices(const SceneSoA *soa, int i, Vector3 *v0, Vector3 *v1, Vector3 *v2) {
+    *v0 = (Vector3){ soa->triangleV0X[i], soa->triangleV0Y[i], soa->triangleV0Z[i] };
+    *v1 = (Vector3){ soa->triangleV1X[i], soa->triangleV1Y[i], soa->triangleV1Z[i] };
+    *v2 = (Vector3){ soa->triangleV2X[i], soa->triangleV2Y[i], soa->triangleV2Z[i] };
+}
+
+// Intersection avec une primitive référencée par le BVH, met à jour le plus proche impact
+static inline void intersectPrimitive(const TracerScene *scene, int ref, Vector3 ro, Vector3 rd, float *minT, Vector3 *n, int *hitIdx, int *hitType) {
+    float t;
+    Vector3 ni;
+    int index = bvhPrimIndex(ref);
+    int type = bvhPrimType(ref);
+    if (type == BVH_PRIM_SPHERE) {
+        if (intersectSphere(ro, rd, sphereCenter(scene->soa, index), scene->soa->sphereRadius[index], &t, &ni) && t < *minT) {
+            *minT = t; *n = ni; *hitIdx = index; *hitType = 0;
+        }
+    } else if (type == BVH_PRIM_BLOCK) {
+        Vector3 blockMin, blockMax;
+        blockBounds(scene->soa, index, &blockMin, &blockMax);
+        if (intersectBox(ro, rd, blockMin, blockMax, &t, &ni) && t < *minT) {
+            *minT = t; *n = ni; *hitIdx = index; *hitType = 1;
+        }
+    } else {
+        Vector3 v0, v1, v2;
+        triangleVertices(scene->soa, index, &v0, &v1, &v2);
+        if (intersectTriangle(ro, rd, v0, v1, v2, &t, &ni) && t < *minT) {
+            *minT = t; *n = ni; *hitIdx = index; *hitType = 2;
+        }
+    }
+}
+
+static inline Vector3 safeInverse(Vector3 rd) {
+    return (Vector3){ 1.0f / rd.x, 1.0f / rd.y, 1.0f / rd.z };
+}
+
+// Intersection la plus proche avec la scène (sphères, murs puis triangles, ou parcours du BVH)
+static void intersectScene(const TracerScene *scene, Vector3 ro, Vector3 rd, float *minT, Vector3 *n, int *hitIdx, int *hitType) {
+    const BvhView *bvh = scene->bvh;
+    if (bvh == NULL) {
+        for (int i = 0; i < scene->soa->sphereCount; ++i) intersectPrimitive(scene, makeBvhPrimRef(i, BVH_PRIM_SPHERE), ro, rd, minT, n, hitIdx, hitType);
+        for (int i = 0; i < scene->soa->blockCount; ++i) intersectPrimitive(scene, makeBvhPrimRef(i, BVH_PRIM_BLOCK), ro, rd, minT, n, hitIdx, hitType);
+        for (int i = 0; i < scene->soa->triangleCount; ++i) intersectPrimitive(scene, makeBvhPrimRef(i, BVH_PRIM_TRIANGLE), ro, rd, minT, n, hitIdx, hitType);
+        return;
+    }
+    if (bvh->nodeCount == 0) return;
+
+    // Parcours avec pile, fils le plus proche en premier
+    Vector3 invDir = safeInverse(rd);
+    int stack[BVH_STACK_SIZE];
+    int stackSize = 0;
+    const BvhNode *node = &bvh->nodes[0];
+    if (intersectBvhBounds(ro, invDir, node->boundsMin, node->boundsMax, *minT) >= 1e30f) return;
+
+    for (;;) {
+        if (node->count > 0) {
+            for (int i = 0; i < node->count; i++) {
+                intersectPrimitive(scene, bvh->primRefs[node->leftFirst + i], ro, rd, minT, n, hitIdx, hitType);
+            }
+        } else {
+            const BvhNode *left = &bvh->nodes[node->leftFirst];
+            const BvhNode *right = left + 1;
+            float tLeft = intersectBvhBounds(ro, invDir, left->boundsMin, left->boundsMax, *minT);
+            float tRight = intersectBvhBounds(ro, invDir, right->boundsMin, right->boundsMax, *minT);
+            if (tLeft > tRight) {
+                float tt = tLeft; tLeft = tRight; tRight = tt;
+                const BvhNode *tn = left; left = right; right = tn;
+            }
+            if (tLeft < 1e30f) {
+                if (tRight < 1e30f && stackSize < BVH_STACK_SIZE) stack[stackSize++] = (int)(right - bvh->nodes);
+                node = left;
+                continue;
+            }
+        }
+
+        // Dépiler le prochain noeud encore plus proche que l'impact courant
+        node = NULL;
+        while (stackSize > 0) {
+            const BvhNode *candidate = &bvh->nodes[stack[--stackSize]];
+            if (intersectBvhBounds(ro, invDir, candidate->boundsMin, candidate->boundsMax, *minT) < 1e30f) {
+                node = candidate;
+                break;
+            }
+        }
+        if (node == NULL) return;
+    }
+}
+
+// Le triangle i coupe-t-il le rayon d'ombre avant maxT ?
+static inline bool triangleOccludes(const SceneSoA *soa, int i, Vector3 origin, Vector3 dir, float maxT) {
+    float t;
+    Vector3 tmp, v0, v1, v2;
+    triangleVertices(soa, i, &v0, &v1, &v2);
+    return intersectTriangle(origin, dir, v0, v1, v2, &t, &tmp) && t < maxT;
+}
+
+// Rayon d'ombre : une sphère (autre que skipSphere) ou un triangle coupe-t-il le segment avant maxT ?
+static bool occludedBySpheres(const TracerScene *scene, Vector3 origin, Vector3 dir, float maxT, int skipSphere) {
+    const BvhView *bvh = scene->bvh;
+    if (bvh == NULL) {
+        const SceneSoA *soa = scene->soa;
+        for (int j = 0; j < soa->sphereCount; ++j) {
+            if (j == skipSphere) continue; // Ignorer la source
+            float t;
+            Vector3 tmp;
+            if (intersectSphere(origin, dir, sphereCenter(soa, j), soa->sphereRadius[j], &t, &tmp) && t < maxT) return true;
+        }
+        for (int j = 0; j < soa->triangleCount; ++j) {
+            if (triangleOccludes(soa, j, origin, dir, maxT)) return true;
+        }
+        return false;
+    }
+    if (bvh->nodeCount == 0) return false;
+
+    Vector3 invDir = safeInverse(dir);
+    int stack[BVH_STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0) {
+        const BvhNode *node = &bvh->nodes[stack[--stackSize]];
+        if (intersectBvhBounds(origin, invDir, node->boundsMin, node->boundsMax, maxT) >= 1e30f) continue;
+
+        if (node->count > 0) {
+            for (int i = 0; i < node->count; i++) {
+                int ref = bvh->primRefs[node->leftFirst + i];
+                int j = bvhPrimIndex(ref);
+                if (bvhPrimType(ref) == BVH_PRIM_TRIANGLE) {
+                    if (triangleOccludes(scene->soa, j, origin, dir, maxT)) return true;
+                    continue;
+                }
+                if (bvhPrimType(ref) != BVH_PRIM_SPHERE || j == skipSphere) continue;
+                float t;
+                Vector3 tmp;
+                if (intersectSphere(origin, dir, sphereCenter(scene->soa, j), scene->soa->sphereRadius[j], &t, &tmp) && t < maxT) return true;
+            }
+        } else if (stackSize + 2 <= BVH_STACK_SIZE) {
+            stack[stackSize++] = node->leftFirst;
+            stack[stackSize++] = node->leftFirst + 1;
+        }
+    }
+    return false;
+}
+
+// Évaluation de la BRDF pour l'échantillonnage direct (même approximations que le shader)
+static Vector3 evalBrdf(const Material2 &mat, Vector3 n, Vector3 viewDir, Vector3 toLight) {
+    Vector3 brdf = { 0.0f, 0.0f, 0.0f };
+    if (mat.type == MAT_DIFFUSE) {
+        brdf = mat.albedo * (1.0f / PI); // Lambert
+    }
+    else if (mat.type == MAT_METALLIC) {
+        Vector3 halfwayDir = Vector3Normalize(toLight + viewDir);
+        float spec = powf(fmaxf(Vector3DotProduct(n, halfwayDir), 0.0f), (1.0f - mat.roughness) * 128.0f + 1.0f);
+        float s = spec * (1.0f - mat.roughness);
+        brdf = (mat.albedo + (Vector3){ s, s, s }) * (1.0f / PI);
+    }
+    else if (mat.type == MAT_GLASS || mat.type == MAT_MIRROR) {
+        Vector3 reflectDir = Vector3Reflect(Vector3Negate(toLight), n);
+        float spec = powf(fmaxf(Vector3DotProduct(viewDir, reflectDir), 0.0f), (1.0f - mat.roughness) * 128.0f + 1.0f);
+        float s = spec * (1.0f - mat.roughness) / PI;
+        brdf = (Vector3){ s, s, s };
+    }
+    return brdf;
+}
+
+// Échantillon de la sphère lumineuse i (rang light parmi les émissives) vu depuis p : rayon d'ombre (origin, toLight, distToLight)
+// et contribution à ajouter s'il n'est pas occulté. Retourne false si le pdf est invalide.
+static bool sampleLight(const TracerScene *scene, int i, int light, Vector3 p, Vector3 n, Vector3 viewDir, const Material2 &mat, float seed,
+                        const PathSampler *sampler, int bounce, Vector3 *toLight, float *distToLight, Vector3 *contrib) {
+    const SceneSoA *soa = scene->soa;
+
+    // Échantillonnage de la sphère lumineuse
+    Vector3 lightCenter = sphereCenter(soa, i);
+    float lightRadius = soa->sphereRadius[i];
+    *distToLight = Vector3Length(lightCenter - p);
+
+    // Génération d'un point aléatoire sur la sphère lumineuse
+    Vector2 rand = sample2D(sampler, samplerLightDim(bounce, light), p, seed + (float)i * 0.773f);
+    float phi = 2.0f * PI * rand.x;
+    float cosTheta = 2.0f * rand.y - 1.0f;
+    float sinTheta = sqrtf(1.0f - cosTheta * cosTheta);
+
+    Vector3 sampleOffset = (Vector3){ cosf(phi) * sinTheta, sinf(phi) * sinTheta, cosTheta } * lightRadius;
+
+    Vector3 samplePos = lightCenter + sampleOffset;
+    *toLight = Vector3Normalize(samplePos - p);
+
+    Vector3 brdf = evalBrdf(mat, n, viewDir, *toLight);
+
+    // Calcul du PDF
+    Vector3 toSample = samplePos - p;
+    float distance2 = Vector3DotProduct(toSample, toSample);
+    float cosLightSurface = fmaxf(Vector3DotProduct(*toLight, Vector3Negate(Vector3Normalize(sampleOffset))), 0.0f);
+    float pdf = distance2 / (cosLightSurface * 4.0f * PI * lightRadius * lightRadius + 0.001f); // éviter /0
+
+    // Contribution lumineuse si pdf valide
+    if (!(pdf > 0.0f)) return false;
+    Vector3 lightAlbedo = { soa->sphereMaterials.albedoR[i], soa->sphereMaterials.albedoG[i], soa->sphereMaterials.albedoB[i] };
+    Vector3 Li = lightAlbedo * scene->lightIntensity;
+    float cosLight = fmaxf(0.0f, Vector3DotProduct(n, *toLight));
+    *contrib = brdf * Li * (cosLight / pdf);
+    return true;
+}
+
+//fonction d'échantillonnage direct de la lumière
+static Vector3 sampleDirectLight(const TracerScene *scene, Vector3 p, Vector3 n, Vector3 viewDir, const Material2 &mat, float seed, const PathSampler *sampler, int bounce) {
+    // Éviter l'auto-intersection avec un petit décalage
+    Vector3 origin = p + n * 0.001f;
+    Vector3 contrib = { 0.0f, 0.0f, 0.0f };
+
+    // Trouver les sources de lumière émissives (sphères)
+    const SceneSoA *soa = scene->soa;
+    int light = 0;
+    for (int i = 0; i < soa->sphereCount; ++i) {
+        if (soa->sphereMaterials.type[i] != MAT_EMISSIVE) continue;
+
+        Vector3 toLight, lightContrib;
+        float distToLight;
+        if (!sampleLight(scene, i, light++, p, n, viewDir, mat, seed, sampler, bounce, &toLight, &distToLight, &lightContrib)) continue;
+
+        // Vérifier la visibilité (ombres), seuls les sphères et les triangles occultent comme dans le shader
+        rayStats.shadowRays++;
+        if (occludedBySpheres(scene, origin, toLight, distToLight, i)) continue;
+        contrib += lightContrib;
+    }
+
+    return contrib;
+}
+
+// Fonction hash 2D rapide pour du bruit pseudo-aléatoire
+static inline float hash21(float px, float py) {
+    px = fract(px * 123.34f);
+    py = fract(py * 456.21f);
+    float d = px * (px + 45.32f) + py * (py + 45.32f);
+    px += d;
+    py += d;
+    return fract(px * py);
+}
+
+static float emissionPattern(Vector3 hitPos, Vector3 blockMin, Vector3 blockMax, float time) {
+    // Coordonnées locales (0..1) sur le mur en X et Y
+    float localX = (hitPos.x - blockMin.x) / (blockMax.x - blockMin.x);
+    float localY = (hitPos.y - blockMin.y) / (blockMax.y - blockMin.y);
+
+    // Coordonnées animées (défilement dans x et y), bouclées sur [0,1]
+    float u = fract(localX + 0.03f * time);
+    float v = fract(localY + 0.05f * time);
+
+    // Échantillonnage du bruit (20 = résolution du motif)
+    float noiseVal = hash21(floorf(u * 20.0f), floorf(v * 20.0f));
+
+    // Seuil pour "allumer" la lumière dans certaines zones, transition lissée
+    float threshold = 0.8f;
+    float x = Clamp((noiseVal - threshold) / 0.1f, 0.0f, 1.0f);
+    return x * x * (3.0f - 2.0f * x);
+}
+
+// Matériau au point d'impact, avec le motif émissif animé des murs
+static Material2 surfaceMaterial(const TracerScene *scene, const TracerSettings *settings, Vector3 hit, int hitIdx, int hitType) {
+    if (hitType == 0) return getMaterial(&scene->soa->sphereMaterials, hitIdx);
+    if (hitType == 2) return getMaterial(&scene->soa->triangleMaterials, hitIdx);
+
+    Vector3 blockMin, blockMax;
+    blockBounds(scene->soa, hitIdx, &blockMin, &blockMax);
+
+    Material2 mat = getMaterial(&scene->soa->blockMaterials, hitIdx);
+    float emissionFactor = emissionPattern(hit, blockMin, blockMax, settings->time);
+    if (emissionFactor > 0.0f) {
+        mat.type = MAT_EMISSIVE;
+        mat.albedo = (Vector3){ 1.0f, 1.0f, 1.0f };
+    }
+    return mat;
+}
+
+// Prochain rayon selon le matériau : une fonction par type pour que le mode wavefront
+// puisse traiter chaque file sans branchement
+static inline void scatterDiffuse(const Material2 &mat, Vector3 hit, Vector3 n, float seed, const PathSampler *sampler, int bounce, Vector3 *ro, Vector3 *rd, Vector3 *throughput) {
+    // Surface diffuse: échantillonnage de l'hémisphère
+    *rd = sampleHemisphere(n, hit, seed + (float)bounce * 3.14159f, sampler, samplerBounceDim(bounce, SAMPLER_DIM_SCATTER));
+    *ro = hit + n * 0.001f;
+    *throughput *= mat.albedo;
+}
+
+static inline void scatterMetallic(const Material2 &mat, Vector3 hit, Vector3 n, float seed, const PathSampler *sampler, int bounce, Vector3 *ro, Vector3 *rd, Vector3 *throughput) {
+    // Surface métallique: réflexion
+    *rd = reflect_custom(*rd, n, mat.roughness, hit, seed + (float)bounce * 2.71828f, sampler, samplerBounceDim(bounce, SAMPLER_DIM_SCATTER));
+    *ro = hit + n * 0.001f;
+    *throughput *= mat.albedo;
+}
+
+static inline void scatterGlass(const Material2 &mat, Vector3 hit, Vector3 n, float minT, float seed, const PathSampler *sampler, int bounce, Vector3 *ro, Vector3 *rd, Vector3 *throughput) {
+    // Verre: réfraction ou réflexion
+    float reflChance;
+    *rd = refract(*rd, n, mat.ior, mat.roughness, hit, seed + (float)bounce * 1.41421f, sampler, bounce, &reflChance);
+    *ro = hit + Vector3Normalize(*rd) * 0.001f;
+
+    // Le verre absorbe un peu de lumière, principalement sur les longues distances
+    float absorbance = 0.1f;
+    Vector3 absorption = { expf(-mat.albedo.x * absorbance * minT),
+                           expf(-mat.albedo.y * absorbance * minT),
+                           expf(-mat.albedo.z * absorbance * minT) };
+    *throughput *= Vector3Lerp(absorption, (Vector3){ 1.0f, 1.0f, 1.0f }, reflChance);
+}
+
+static inline void scatterMirror(const Material2 &mat, Vector3 hit, Vector3 n, float seed, const PathSampler *sampler, int bounce, Vector3 *ro, Vector3 *rd, Vector3 *throughput) {
+    // Miroir: réflexion
+    *rd = reflect_custom(*rd, n, mat.roughness, hit, seed + (float)bounce * 1.73205f, sampler, samplerBounceDim(bounce, SAMPLER_DIM_SCATTER));
+    *ro = hit + n * 0.001f;
+    *throughput *= mat.albedo;
+}
+
+// Roulette russe pour terminer prématurément les chemins à faible contribution
+static inline bool survivesRoulette(Vector3 hit, float seed, const PathSampler *sampler, int bounce, Vector3 *throughput) {
+    if (bounce <= 2) return true;
+    float p = fmaxf(throughput->x, fmaxf(throughput->y, throughput->z));
+    p = Clamp(p, 0.0f, 1.0f);
+    if (sample1D(sampler, samplerBounceDim(bounce, SAMPLER_DIM_ROULETTE), hit, seed + (float)bounce * 0.77f) > p) return false;
+    *throughput = *throughput * (1.0f / p);
+    return true;
+}
+
+// Ciel dégradé simple
+static inline Vector3 skyColor(Vector3 rd) {
+    float t = 0.5f * (rd.y + 1.0f);
+    return Vector3Lerp((Vector3){ 1.0f, 1.0f, 1.0f }, (Vector3){ 0.5f, 0.7f, 1.0f }, t);
+}
+
+// Premier impact déjà calculé par un paquet de rayons (hitIdx = -1 : ciel)
+typedef struct {
+    int hitIdx;
+    int hitType;
+} PrimaryHit;
+
+static Vector3 traceFrom(const TracerScene *scene, const TracerSettings *settings, Vector3 ro, Vector3 rd, float seed, const PathSampler *sampler, const PrimaryHit *primary) {
+    Vector3 col = { 0.0f, 0.0f, 0.0f };
+    Vector3 throughput = { 1.0f, 1.0f, 1.0f };
+
+    for (int bounce = 0; bounce < settings->maxBounces; ++bounce) {
+        rayStats.extensionRays++;
+        float minT = 1e9f;
+        int hitIdx = -1;
+        int hitType = 0; // 0 = sphère, 1 = mur, 2 = triangle
+        Vector3 n = { 0.0f, 0.0f, 0.0f };
+
+        // Trouver l'intersection la plus proche
+        if (bounce == 0 && primary != NULL && primary->hitIdx >= 0) {
+            // Primitive connue : on recalcule t et la normale en scalaire pour garder les mêmes valeurs
+            intersectPrimitive(scene, makeBvhPrimRef(primary->hitIdx, primary->hitType), ro, rd, &minT, &n, &hitIdx, &hitType);
+            if (hitIdx < 0) intersectScene(scene, ro, rd, &minT, &n, &hitIdx, &hitType);
+        }
+        else if (bounce > 0 || primary == NULL) {
+            intersectScene(scene, ro, rd, &minT, &n, &hitIdx, &hitType);
+        }
+        Vector3 hit = ro + rd * minT;
+
+        // Si pas d'intersection, ajouter un fond dégradé et sortir
+        if (hitIdx == -1) {
+            col += throughput * skyColor(rd) * 0.3f;
+            break;
+        }
+
+        // Après avoir trouvé l'intersection:
+        Material2 mat = surfaceMaterial(scene, settings, hit, hitIdx, hitType);
+
+        // Si on touche une source émissive, ajouter sa contribution et terminer
+        if (mat.type == MAT_EMISSIVE) {
+            col += throughput * mat.albedo * scene->lightIntensity;
+            break;
+        }
+
+        // Ajout de l'échantillonnage direct de la lumière (NEE)
+        Vector3 directLight = sampleDirectLight(scene, hit, n, Vector3Negate(rd), mat, seed + (float)bounce * 1.618f, sampler, bounce);
+        col += throughput * directLight;
+
+        // Calculer le prochain rayon en fonction du matériau
+        if (mat.type == MAT_DIFFUSE) scatterDiffuse(mat, hit, n, seed, sampler, bounce, &ro, &rd, &throughput);
+        else if (mat.type == MAT_METALLIC) scatterMetallic(mat, hit, n, seed, sampler, bounce, &ro, &rd, &throughput);
+        else if (mat.type == MAT_GLASS) scatterGlass(mat, hit, n, minT, seed, sampler, bounce, &ro, &rd, &throughput);
+        else if (mat.type == MAT_MIRROR) scatterMirror(mat, hit, n, seed, sampler, bounce, &ro, &rd, &throughput);
+
+        if (!survivesRoulette(hit, seed, sampler, bounce, &throughput)) break;
+    }
+
+    return col;
+}
+
+Vector3 tracePath(const TracerScene *scene, const TracerSettings *settings, Vector3 ro, Vector3 rd, float seed, const PathSampler *sampler) {
+    return traceFrom(scene, settings, ro, rd, seed, sampler, NULL);
+}
+
+// Équivalent de setCamera() : colonnes cu, cv, cw
+static void setCamera(Vector3 ro, Vector3 ta, Vector3 *cu, Vector3 *cv, Vector3 *cw) {
+    *cw = Vector3Normalize(ta - ro);
+    Vector3 cp = { 0.0f, 1.0f, 0.0f };
+    *cu = Vector3Normalize(Vector3CrossProduct(*cw, cp));
+    *cv = Vector3Normalize(Vector3CrossProduct(*cu, *cw));
+}
+
+typedef struct {
+    Vector3 cu, cv, cw;
+    int strataCount;
+    float strataSize;
+} CameraFrame;
+
+static CameraFrame makeCameraFrame(const TracerSettings *settings) {
+    CameraFrame frame;
+    setCamera(settings->viewEye, settings->viewCenter, &frame.cu, &frame.cv, &frame.cw);
+    // Anti-aliasing: multiplier les échantillons par pixel
+    frame.strataCount = (int)sqrtf((float)settings->samples);
+    frame.strataSize = 1.0f / sqrtf((float)settings->samples);
+    return frame;
+}
+
+// Rayon caméra, graine et échantillonneur de l'échantillon s (fragCoord = centre du pixel, origine en bas)
+static void cameraRay(const TracerSettings *settings, const CameraFrame *frame, float fragX, float fragY, int s, Vector3 *rd, float *seed, PathSampler *sampler) {
+    rayStats.primaryRays++;
+    s += settings->sampleOffset;
+    Vector3 pixelPos = { fragX, fragY, settings->time };
+    Vector3 pixelSeedPos = { fragX, fragY, 0.0f };
+    *sampler = makePathSampler(settings->samplerType, (int)fragX, (int)fragY, settings->time, s);
+
+    float jx, jy;
+    if (settings->samplerType == SAMPLER_HASH) {
+        // Calculer le décalage du sous-pixel pour l'anti-aliasing (au-delà de samples,
+        // l'échantillonnage adaptatif reprend les mêmes strates)
+        int strataIndex = s % settings->samples;
+        int strataX = strataIndex % frame->strataCount;
+        int strataY = strataIndex / frame->strataCount;
+
+        jx = (float)strataX * frame->strataSize + random(pixelPos, (float)s * 0.1f) * frame->strataSize - 0.5f;
+        jy = (float)strataY * frame->strataSize + random(pixelPos, (float)s * 0.2f) * frame->strataSize - 0.5f;
+    } else {
+        // La suite est déjà stratifiée dans le pixel pour tout nombre d'échantillons
+        Vector2 jitter = sampleLowDiscrepancy(sampler, SAMPLER_DIM_CAMERA);
+        jx = jitter.x - 0.5f;
+        jy = jitter.y - 0.5f;
+    }
+
+    float u = ((fragX + jx) * 2.0f - (float)settings->width) / (float)settings->height;
+    float v = ((fragY + jy) * 2.0f - (float)settings->height) / (float)settings->height;
+
+    Vector3 local = Vector3Normalize((Vector3){ u, v, 1.5f });
+    *rd = frame->cu * local.x + frame->cv * local.y + frame->cw * local.z;
+
+    // Seed pour le générateur de nombres aléatoires
+    *seed = (float)s + random(pixelSeedPos, settings->time);
+}
+
+// Triangles des paquets : pas de noyau vectorisé, chaque rayon est testé en scalaire
+static void intersectPacketTriangle(const SceneSoA *soa, RayPacket *packet, int index) {
+    Vector3 v0, v1, v2;
+    triangleVertices(soa, index, &v0, &v1, &v2);
+    for (int lane = 0; lane < RAY_PACKET_SIZE; lane++) {
+        float t;
+        Vector3 n;
+        Vector3 ro = { packet->ox[lane], packet->oy[lane], packet->oz[lane] };
+        Vector3 rd = { packet->dx[lane], packet->dy[lane], packet->dz[lane] };
+        if (intersectTriangle(ro, rd, v0, v1, v2, &t, &n) && t < packet->t[lane]) {
+            packet->t[lane] = t;
+            packet->hitIdx[lane] = index;
+            packet->hitType[lane] = 2;
+        }
+    }
+}
+
+// Premiers impacts d'un paquet : toutes les primitives, ou parcours du BVH tant qu'un rayon est actif
+static void intersectPacket(const TracerScene *scene, const PacketKernels *kernels, RayPacket *packet) {
+    const BvhView *bvh = scene->bvh;
+    const SceneSoA *soa = scene->soa;
+    if (bvh == NULL) {
+        // Parcours continu des tableaux SoA
+        for (int i = 0; i < soa->sphereCount; ++i) {
+            kernels->intersectSphere(packet, soa->sphereX[i], soa->sphereY[i], soa->sphereZ[i], soa->sphereRadius[i], i);
+        }
+        for (int i = 0; i < soa->blockCount; ++i) {
+            Vector3 blockMin, blockMax;
+            blockBounds(soa, i, &blockMin, &blockMax);
+            kernels->intersectBox(packet, &blockMin.x, &blockMax.x, i);
+        }
+        for (int i = 0; i < soa->triangleCount; ++i) intersectPacketTriangle(soa, packet, i);
+        return;
+    }
+    if (bvh->nodeCount == 0) return;
+
+    int stack[BVH_STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0) {
+        const BvhNode *node = &bvh->nodes[stack[--stackSize]];
+        if (kernels->intersectBounds(packet, &node->boundsMin.x, &node->boundsMax.x) == 0) continue;
+
+        if (node->count > 0) {
+            for (int i = 0; i < node->count; i++) {
+                int ref = bvh->primRefs[node->leftFirst + i];
+                int index = bvhPrimIndex(ref);
+                if (bvhPrimType(ref) == BVH_PRIM_SPHERE) {
+                    kernels->intersectSphere(packet, soa->sphereX[index], soa->sphereY[index], soa->sphereZ[index], soa->sphereRadius[index], index);
+                } else if (bvhPrimType(ref) == BVH_PRIM_TRIANGLE) {
+                    intersectPacketTriangle(soa, packet, index);
+                } else {
+                    Vector3 blockMin, blockMax;
+                    blockBounds(soa, index, &blockMin, &blockMax);
+                    kernels->intersectBox(packet, &blockMin.x, &blockMax.x, index);
+                }
+            }
+        } else if (stackSize + 2 <= BVH_STACK_SIZE) {
+            stack[stackSize++] = node->leftFirst + 1;
+            stack[stackSize++] = node->leftFirst;
+        }
+    }
+}
+
+// Équivalent de main() de raytest.fs pour un pixel
+static Vector3 renderPixel(const TracerScene *scene, const TracerSettings *settings, const CameraFrame *frame, float fragX, float fragY) {
+    Vector3 color = { 0.0f, 0.0f, 0.0f };
+
+    for (int s = 0; s < settings->samples; ++s) {
+        Vector3 rd;
+        float seed;
+        PathSampler sampler;
+        cameraRay(settings, frame, fragX, fragY, s, &rd, &seed, &sampler);
+        color += tracePath(scene, settings, settings->viewEye, rd, seed, &sampler);
+    }
+
+    // Moyenne des échantillons
+    return color * (1.0f / (float)settings->samples);
+}
+
+// Même chose pour RAY_PACKET_SIZE pixels voisins d'une ligne : les rayons caméra de
+// chaque échantillon sont intersectés ensemble, les rebonds suivants restent scalaires
+static void renderPixelPacket(const TracerScene *scene, const TracerSettings *settings, const CameraFrame *frame, int x0, int activeCount, float fragY, Vector3 *colors) {
+    for (int lane = 0; lane < activeCount; lane++) colors[lane] = (Vector3){ 0.0f, 0.0f, 0.0f };
+
+    RayPacket packet;
+    float seeds[RAY_PACKET_SIZE];
+    PathSampler samplers[RAY_PACKET_SIZE];
+    for (int s = 0; s < settings->samples; ++s) {
+        for (int lane = 0; lane < RAY_PACKET_SIZE; lane++) {
+            // Les lanes inactives dupliquent le dernier pixel valide
+            int x = x0 + (lane < activeCount ? lane : activeCount - 1);
+            Vector3 rd;
+            cameraRay(settings, frame, (float)x + 0.5f, fragY, s, &rd, &seeds[lane], &samplers[lane]);
+            packet.ox[lane] = settings->viewEye.x; packet.oy[lane] = settings->viewEye.y; packet.oz[lane] = settings->viewEye.z;
+            packet.dx[lane] = rd.x; packet.dy[lane] = rd.y; packet.dz[lane] = rd.z;
+        }
+        initRayPacket(&packet, activeCount);
+        intersectPacket(scene, settings->packetKernels, &packet);
+
+        for (int lane = 0; lane < activeCount; lane++) {
+            PrimaryHit primary = { packet.hitIdx[lane], packet.hitType[lane] };
+            Vector3 rd = { packet.dx[lane], packet.dy[lane], packet.dz[lane] };
+            colors[lane] += traceFrom(scene, settings, settings->viewEye, rd, seeds[lane], &samplers[lane], &primary);
+        }
+    }
+
+    for (int lane = 0; lane < activeCount; lane++) colors[lane] = colors[lane] * (1.0f / (float)settings->samples);
+}
+
+typedef struct {
+    const TracerScene *scene;
+    const TracerSettings *settings;
+    float *framebuffer;
+    CameraFrame frame;
+    TracerStats *stats;
+    std::mutex statsLock;
+} TileContext;
+
+// Mode wavefront : tous les chemins d'une tuile (pixels x échantillons) avancent d'un
+// rebond à la fois. Chaque rebond enchaîne des étapes homogènes :
+//   1. intersection de tous les rayons actifs (par paquets si disponibles)
+//   2. tri des impacts en files par matériau (ciel et émissifs terminent le chemin)
+//   3. génération des rayons d'ombre (NEE) puis test d'occultation en lot
+//   4. rebond spécialisé par file de matériau, roulette russe
+// Les graines et l'ordre des opérations sont ceux de traceFrom() : l'image est identique.
+enum {
+    QUEUE_DIFFUSE,
+    QUEUE_METALLIC,
+    QUEUE_GLASS,
+    QUEUE_MIRROR,
+    QUEUE_COUNT
+};
+
+typedef struct {
+    Vector3 origin;
+    Vector3 dir;
+    float maxT;
+    int skipSphere;
+    Vector3 contrib;
+    int path;
+} ShadowRay;
+
+// État des chemins en structure de tableaux, réutilisé d'une tuile à l'autre
+typedef struct {
+    std::vector<Vector3> ro, rd, throughput, color, direct;
+    std::vector<Vector3> hit, normal;
+    std::vector<float> seed, minT;
+    std::vector<PathSampler> sampler;
+    std::vector<int> hitIdx, hitType;
+    std::vector<Material2> material;
+    std::vector<int> active, next;
+    std::vector<int> queues[QUEUE_COUNT];
+    std::vector<ShadowRay> shadows;
+} Wavefront;
+
+static void resizeWavefront(Wavefront *wf, int pathCount) {
+    wf->ro.resize(pathCount); wf->rd.resize(pathCount);
+    wf->throughput.resize(pathCount); wf->color.resize(pathCount); wf->direct.resize(pathCount);
+    wf->hit.resize(pathCount); wf->normal.resize(pathCount);
+    wf->seed.resize(pathCount); wf->minT.resize(pathCount);
+    wf->sampler.resize(pathCount);
+    wf->hitIdx.resize(pathCount); wf->hitType.resize(pathCount);
+    wf->material.resize(pathCount);
+    wf->active.clear(); wf->next.clear();
+    wf->shadows.clear();
+}
+
+// Étape 1 : impact le plus proche de chaque chemin actif
+static void wavefrontExtend(const TracerScene *scene, const TracerSettings *settings, Wavefront *wf) {
+    int count = (int)wf->active.size();
+    const PacketKernels *kernels = settings->packetKernels;
+    rayStats.extensionRays += count;
+
+    if (kernels == NULL) {
+        for (int k = 0; k < count; k++) {
+            int p = wf->active[k];
+            wf->minT[p] = 1e9f; wf->hitIdx[p] = -1; wf->hitType[p] = 0;
+            wf->normal[p] = (Vector3){ 0.0f, 0.0f, 0.0f };
+            intersectScene(scene, wf->ro[p], wf->rd[p], &wf->minT[p], &wf->normal[p], &wf->hitIdx[p], &wf->hitType[p]);
+        }
+        return;
+    }
+
+    // Paquets de rayons quelconques : le parcours reste correct, seul le gain SIMD
+    // diminue quand les directions divergent après plusieurs rebonds
+    RayPacket packet;
+    for (int k0 = 0; k0 < count; k0 += RAY_PACKET_SIZE) {
+        int activeCount = count - k0 < RAY_PACKET_SIZE ? count - k0 : RAY_PACKET_SIZE;
+        for (int lane = 0; lane < RAY_PACKET_SIZE; lane++) {
+            int p = wf->active[k0 + (lane < activeCount ? lane : activeCount - 1)];
+            packet.ox[lane] = wf->ro[p].x; packet.oy[lane] = wf->ro[p].y; packet.oz[lane] = wf->ro[p].z;
+            packet.dx[lane] = wf->rd[p].x; packet.dy[lane] = wf->rd[p].y; packet.dz[lane] = wf->rd[p].z;
+        }
+        initRayPacket(&packet, activeCount);
+        intersectPacket(scene, kernels, &packet);
+
+        for (int lane = 0; lane < activeCount; lane++) {
+            int p = wf->active[k0 + lane];
+            wf->minT[p] = 1e9f; wf->hitIdx[p] = -1; wf->hitType[p] = 0;
+            wf->normal[p] = (Vector3){ 0.0f, 0.0f, 0.0f };
+            if (packet.hitIdx[lane] < 0) continue;
+            // Même recalcul scalaire de t et de la normale que renderPixelPacket()
+            intersectPrimitive(scene, makeBvhPrimRef(packet.hitIdx[lane], packet.hitType[lane]), wf->ro[p], wf->rd[p],
+                               &wf->minT[p], &wf->normal[p], &wf->hitIdx[p], &wf->hitType[p]);
+            if (wf->hitIdx[p] < 0) intersectScene(scene, wf->ro[p], wf->rd[p], &wf->minT[p], &wf->normal[p], &wf->hitIdx[p], &wf->hitType[p]);
+        }
+    }
+}
+
+// Étape 2 : terminaison (ciel, émissif) ou rangement dans la file du matériau
+static void wavefrontSort(const TracerScene *scene, const TracerSettings *settings, Wavefront *wf) {
+    for (int q = 0; q < QUEUE_COUNT; q++) wf->queues[q].clear();
+
+    for (size_t k = 0; k < wf->active.size(); k++) {
+        int p = wf->active[k];
+        if (wf->hitIdx[p] == -1) {
+            wf->color[p] += wf->throughput[p] * skyColor(wf->rd[p]) * 0.3f;
+            continue;
+        }
+
+        Vector3 hit = wf->ro[p] + wf->rd[p] * wf->minT[p];
+        Material2 mat = surfaceMaterial(scene, settings, hit, wf->hitIdx[p], wf->hitType[p]);
+        if (mat.type == MAT_EMISSIVE) {
+            wf->color[p] += wf->throughput[p] * mat.albedo * scene->lightIntensity;
+            continue;
+        }
+
+        wf->hit[p] = hit;
+        wf->material[p] = mat;
+        if (mat.type == MAT_DIFFUSE) wf->queues[QUEUE_DIFFUSE].push_back(p);
+        else if (mat.type == MAT_METALLIC) wf->queues[QUEUE_METALLIC].push_back(p);
+        else if (mat.type == MAT_GLASS) wf->queues[QUEUE_GLASS].push_back(p);
+        else if (mat.type == MAT_MIRROR) wf->queues[QUEUE_MIRROR].push_back(p);
+    }
+}
+
+// Étape 3 : rayons d'ombre de tous les chemins encore actifs, puis occultation en lot
+static void wavefrontDirectLight(const TracerScene *scene, Wavefront *wf, int bounce) {
+    const SceneSoA *soa = scene->soa;
+    wf->shadows.clear();
+
+    for (int q = 0; q < QUEUE_COUNT; q++) {
+        const std::vector<int> &queue = wf->queues[q];
+        for (size_t k = 0; k < queue.size(); k++) {
+            int p = queue[k];
+            wf->direct[p] = (Vector3){ 0.0f, 0.0f, 0.0f };
+            Vector3 n = wf->normal[p];
+            Vector3 viewDir = Vector3Negate(wf->rd[p]);
+            float seed = wf->seed[p] + (float)bounce * 1.618f;
+
+            int light = 0;
+            for (int i = 0; i < soa->sphereCount; ++i) {
+                if (soa->sphereMaterials.type[i] != MAT_EMISSIVE) continue;
+                ShadowRay shadow;
+                if (!sampleLight(scene, i, light++, wf->hit[p], n, viewDir, wf->material[p], seed, &wf->sampler[p], bounce, &shadow.dir, &shadow.maxT, &shadow.contrib)) continue;
+                shadow.origin = wf->hit[p] + n * 0.001f;
+                shadow.skipSphere = i;
+                shadow.path = p;
+                wf->shadows.push_back(shadow);
+            }
+        }
+    }
+
+    // Les rayons d'ombre d'un chemin sont consécutifs : même ordre de sommation que sampleDirectLight()
+    rayStats.shadowRays += (long long)wf->shadows.size();
+    for (size_t k = 0; k < wf->shadows.size(); k++) {
+        const ShadowRay &shadow = wf->shadows[k];
+        if (occludedBySpheres(scene, shadow.origin, shadow.dir, shadow.maxT, shadow.skipSphere)) continue;
+        wf->direct[shadow.path] += shadow.contrib;
+    }
+
+    for (int q = 0; q < QUEUE_COUNT; q++) {
+        const std::vector<int> &queue = wf->queues[q];
+        for (size_t k = 0; k < queue.size(); k++) {
+            int p = queue[k];
+            wf->color[p] += wf->throughput[p] * wf->direct[p];
+        }
+    }
+}
+
+// Étape 4 : une boucle sans branchement de matériau par file, puis roulette russe
+static void wavefrontScatter(Wavefront *wf, int bounce) {
+    const std::vector<int> &diffuse = wf->queues[QUEUE_DIFFUSE];
+    for (size_t k = 0; k < diffuse.size(); k++) {
+        int p = diffuse[k];
+        scatterDiffuse(wf->material[p], wf->hit[p], wf->normal[p], wf->seed[p], &wf->sampler[p], bounce, &wf->ro[p], &wf->rd[p], &wf->throughput[p]);
+    }
+    const std::vector<int> &metallic = wf->queues[QUEUE_METALLIC];
+    for (size_t k = 0; k < metallic.size(); k++) {
+        int p = metallic[k];
+        scatterMetallic(wf->material[p], wf->hit[p], wf->normal[p], wf->seed[p], &wf->sampler[p], bounce, &wf->ro[p], &wf->rd[p], &wf->throughput[p]);
+    }
+    const std::vector<int> &glass = wf->queues[QUEUE_GLASS];
+    for (size_t k = 0; k < glass.size(); k++) {
+        int p = glass[k];
+        scatterGlass(wf->material[p], wf->hit[p], wf->normal[p], wf->minT[p], wf->seed[p], &wf->sampler[p], bounce, &wf->ro[p], &wf->rd[p], &wf->throughput[p]);
+    }
+    const std::vector<int> &mirror = wf->queues[QUEUE_MIRROR];
+    for (size_t k = 0; k < mirror.size(); k++) {
+        int p = mirror[k];
+        scatterMirror(wf->material[p], wf->hit[p], wf->normal[p], wf->seed[p], &wf->sampler[p], bounce, &wf->ro[p], &wf->rd[p], &wf->throughput[p]);
+    }
+
+    wf->next.clear();
+    for (int q = 0; q < QUEUE_COUNT; q++) {
+        const std::vector<int> &queue = wf->queues[q];
+        for (size_t k = 0; k < queue.size(); k++) {
+            int p = queue[k];
+            if (survivesRoulette(wf->hit[p], wf->seed[p], &wf->sampler[p], bounce, &wf->throughput[p])) wf->next.push_back(p);
+        }
+    }
+    wf->active.swap(wf->next);
+}
+
+static void renderTileWavefront(const Tile *tile, const TracerScene *scene, const TracerSettings *settings, const CameraFrame *frame, float *framebuffer) {
+    static thread_local Wavefront wf;
+    int samples = settings->samples;
+    int pathCount = tile->width * tile->height * samples;
+    resizeWavefront(&wf, pathCount);
+
+    // Génération des rayons caméra : chemin = pixel * samples + échantillon
+    for (int j = 0; j < tile->height; j++) {
+        float fragY = (float)(settings->height - 1 - (tile->y + j)) + 0.5f;
+        for (int i = 0; i < tile->width; i++) {
+            float fragX = (float)(tile->x + i) + 0.5f;
+            for (int s = 0; s < samples; s++) {
+                int p = (j * tile->width + i) * samples + s;
+                cameraRay(settings, frame, fragX, fragY, s, &wf.rd[p], &wf.seed[p], &wf.sampler[p]);
+                wf.ro[p] = settings->viewEye;
+                wf.throughput[p] = (Vector3){ 1.0f, 1.0f, 1.0f };
+                wf.color[p] = (Vector3){ 0.0f, 0.0f, 0.0f };
+                wf.active.push_back(p);
+            }
+        }
+    }
+
+    for (int bounce = 0; bounce < settings->maxBounces && !wf.active.empty(); ++bounce) {
+        wavefrontExtend(scene, settings, &wf);
+        wavefrontSort(scene, settings, &wf);
+        wavefrontDirectLight(scene, &wf, bounce);
+        wavefrontScatter(&wf, bounce);
+    }
+
+    // Moyenne des échantillons dans l'ordre de renderPixel()
+    for (int j = 0; j < tile->height; j++) {
+        float *row = framebuffer + 3*((tile->y + j)*settings->width + tile->x);
+        for (int i = 0; i < tile->width; i++) {
+            Vector3 c = { 0.0f, 0.0f, 0.0f };
+            for (int s = 0; s < samples; s++) c += wf.color[(j * tile->width + i) * samples + s];
+            c = c * (1.0f / (float)samples);
+            row[3*i + 0] = c.x;
+            row[3*i + 1] = c.y;
+            row[3*i + 2] = c.z;
+        }
+    }
+}
+
+static void renderTileScanlines(const Tile *tile, const TileContext *ctx) {
+    const TracerScene *scene = ctx->scene;
+    const TracerSettings *settings = ctx->settings;
+
+    for (int y = tile->y; y < tile->y + tile->height; y++) {
+        // Ligne 0 du framebuffer = haut de l'image, gl_FragCoord.y part du bas
+        float fragY = (float)(settings->height - 1 - y) + 0.5f;
+        float *row = ctx->framebuffer + 3*y*settings->width;
+        int xEnd = tile->x + tile->width;
+
+        if (settings->packetKernels != NULL) {
+            for (int x0 = tile->x; x0 < xEnd; x0 += RAY_PACKET_SIZE) {
+                int activeCount = xEnd - x0 < RAY_PACKET_SIZE ? xEnd - x0 : RAY_PACKET_SIZE;
+                Vector3 colors[RAY_PACKET_SIZE];
+                renderPixelPacket(scene, settings, &ctx->frame, x0, activeCount, fragY, colors);
+                for (int lane = 0; lane < activeCount; lane++) {
+                    float *out = row + 3*(x0 + lane);
+                    out[0] = colors[lane].x;
+                    out[1] = colors[lane].y;
+                    out[2] = colors[lane].z;
+                }
+            }
+            continue;
+        }
+
+        for (int x = tile->x; x < xEnd; x++) {
+            Vector3 c = renderPixel(scene, settings, &ctx->frame, (float)x + 0.5f, fragY);
+            float *out = row + 3*x;
+            out[0] = c.x;
+            out[1] = c.y;
+            out[2] = c.z;
+        }
+    }
+}
+
+static void renderTile(const Tile *tile, void *userData) {
+    TileContext *ctx = (TileContext *)userData;
+    rayStats = TracerStats();
+
+    if (ctx->settings->wavefront) renderTileWavefront(tile, ctx->scene, ctx->settings, &ctx->frame, ctx->framebuffer);
+    else renderTileScanlines(tile, ctx);
+
+    if (ctx->stats != NULL) {
+        std::lock_guard<std::mutex> guard(ctx->statsLock);
+        ctx->stats->primaryRays += rayStats.primaryRays;
+        ctx->stats->extensionRays += rayStats.extensionRays;
+        ctx->stats->shadowRays += rayStats.shadowRays;
+    }
+}
+
+void renderCpu(const TracerScene *scene, const TracerSettings *settings, float *framebuffer, std::vector<TileTiming> *tileTimings, TracerStats *stats) {
+    TileContext ctx;
+    ctx.scene = scene;
+    ctx.settings = settings;
+    ctx.framebuffer = framebuffer;
+    ctx.frame = makeCameraFrame(settings);
+    ctx.stats = stats;
+    if (stats != NULL) *stats = TracerStats();
+
+    runTiles(settings->width, settings->height, settings->tileSize, settings->threadCount, renderTile, &ctx, tileTimings);
+}
+
+// Échantillonnage adaptatif : tampon d'accumulation par pixel (somme RGB, somme et somme
+// des carrés de la luminance, nombre d'échantillons) rempli en plusieurs passes
+typedef struct {
+    std::vector<Vector3> sum;
+    std::vector<double> lumSum, lumSumSq;
+    std::vector<int> count;
+    std::vector<int> extra;   // échantillons à ajouter pendant la passe courante
+} AdaptiveBuffer;
+
+typedef struct {
+    const TracerScene *scene;
+    const TracerSettings *settings;
+    CameraFrame frame;
+    AdaptiveBuffer *buffer;
+} AdaptiveContext;
+
+static inline float luminance(Vector3 c) {
+    return 0.2126f * c.x + 0.7152f * c.y + 0.0722f * c.z;
+}
+
+// Écart type des échantillons (luminance) ramené dans l'espace tone mappé x / (1 + x) :
+// la dérivée 1 / (1 + x)^2 réduit le poids des zones déjà saturées
+static float pixelDeviation(const AdaptiveBuffer *buffer, int pixel) {
+    int n = buffer->count[pixel];
+    double mean = buffer->lumSum[pixel] / n;
+    double variance = (buffer->lumSumSq[pixel] - mean * buffer->lumSum[pixel]) / (n - 1);
+    if (variance < 0.0) variance = 0.0;
+    return (float)(sqrt(variance) / ((1.0 + mean) * (1.0 + mean)));
+}
+
+static void renderTileAdaptive(const Tile *tile, void *userData) {
+    const AdaptiveContext *ctx = (const AdaptiveContext *)userData;
+    const TracerSettings *settings = ctx->settings;
+    AdaptiveBuffer *buffer = ctx->buffer;
+
+    for (int y = tile->y; y < tile->y + tile->height; y++) {
+        float fragY = (float)(settings->height - 1 - y) + 0.5f;
+        for (int x = tile->x; x < tile->x + tile->width; x++) {
+            int pixel = y * settings->width + x;
+            int first = buffer->count[pixel];
+            for (int s = first; s < first + buffer->extra[pixel]; s++) {
+                Vector3 rd;
+                float seed;
+                PathSampler sampler;
+                cameraRay(settings, &ctx->frame, (float)x + 0.5f, fragY, s, &rd, &seed, &sampler);
+                Vector3 c = tracePath(ctx->scene, settings, settings->viewEye, rd, seed, &sampler);
+                double l = luminance(c);
+                buffer->sum[pixel] += c;
+                buffer->lumSum[pixel] += l;
+                buffer->lumSumSq[pixel] += l * l;
+            }
+            buffer->count[pixel] = first + buffer->extra[pixel];
+            buffer->extra[pixel] = 0;
+        }
+    }
+}
+
+void renderCpuAdaptive(const TracerScene *scene, const TracerSettings *settings, float *framebuffer, std::vector<int> *sampleCounts) {
+    int pixelCount = settings->width * settings->height;
+    long long budget = (long long)settings->samples * pixelCount;
+    int minSamples = settings->adaptiveMinSamples < 2 ? 2 : settings->adaptiveMinSamples;
+    int maxSamples = settings->adaptiveMaxSamples < minSamples ? minSamples : settings->adaptiveMaxSamples;
+
+    AdaptiveBuffer buffer;
+    buffer.sum.assign(pixelCount, (Vector3){ 0.0f, 0.0f, 0.0f });
+    buffer.lumSum.assign(pixelCount, 0.0);
+    buffer.lumSumSq.assign(pixelCount, 0.0);
+    buffer.count.assign(pixelCount, 0);
+    buffer.extra.assign(pixelCount, minSamples);
+
+    AdaptiveContext ctx;
+    ctx.scene = scene;
+    ctx.settings = settings;
+    ctx.frame = makeCameraFrame(settings);
+    ctx.buffer = &buffer;
+
+    // Passe initiale : minSamples partout pour estimer la variance
+    runTiles(settings->width, settings->height, settings->tileSize, settings->threadCount, renderTileAdaptive, &ctx, NULL);
+    long long used = (long long)minSamples * pixelCount;
+
+    // L'erreur quadratique totale sum(sigma^2 / n) est minimale pour n proportionnel à sigma :
+    // chaque passe rapproche le nombre d'échantillons des pixels actifs de cette cible
+    std::vector<float> rawDeviations(pixelCount), deviations(pixelCount);
+    while (used < budget) {
+        // Estimation par pixel trop bruitée avec peu d'échantillons (un événement rare peut
+        // manquer) : moyenne sur le voisinage 3x3, plus un plancher défensif
+        double meanDeviation = 0.0;
+        for (int i = 0; i < pixelCount; i++) {
+            rawDeviations[i] = pixelDeviation(&buffer, i);
+            meanDeviation += rawDeviations[i];
+        }
+        meanDeviation /= pixelCount;
+
+        double deviationSum = 0.0;
+        long long activeSamples = 0;
+        int activeCount = 0;
+        for (int i = 0; i < pixelCount; i++) {
+            int x = i % settings->width, y = i / settings->width;
+            float neighborhood = 0.0f;
+            int neighbors = 0;
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    int nx = x + dx, ny = y + dy;
+                    if (nx < 0 || ny < 0 || nx >= settings->width || ny >= settings->height) continue;
+                    neighborhood += rawDeviations[ny * settings->width + nx];
+                    neighbors++;
+                }
+            }
+            float d = neighborhood / (float)neighbors;
+            // Convergé : écart type de la moyenne sous le seuil, le pixel n'est plus échantillonné
+            if (d / sqrtf((float)buffer.count[i]) <= settings->adaptiveThreshold || buffer.count[i] >= maxSamples) d = 0.0f;
+            else d += ADAPTIVE_UNIFORM_WEIGHT * (float)meanDeviation;
+            deviations[i] = d;
+            if (d > 0.0f) {
+                deviationSum += d;
+                activeSamples += buffer.count[i];
+                activeCount++;
+            }
+        }
+        if (activeCount == 0) break;
+
+        long long passBudget = (long long)activeCount * ADAPTIVE_PASS_SAMPLES;
+        if (passBudget > budget - used) passBudget = budget - used;
+
+        // Déficit de chaque pixel par rapport à sa cible, puis mise à l'échelle du budget de la passe
+        double deficitSum = 0.0;
+        for (int i = 0; i < pixelCount; i++) {
+            if (deviations[i] <= 0.0f) continue;
+            double target = (double)(activeSamples + passBudget) * deviations[i] / deviationSum;
+            double deficit = target - buffer.count[i];
+            deviations[i] = deficit > 0.0 ? (float)deficit : 0.0f;
+            deficitSum += deviations[i];
+        }
+        if (deficitSum <= 0.0) break;
+
+        // Reste fractionnaire propagé d'un pixel au suivant pour respecter le budget
+        double carry = 0.0;
+        long long assigned = 0;
+        for (int i = 0; i < pixelCount; i++) {
+            if (deviations[i] <= 0.0f) continue;
+            carry += (double)passBudget * deviations[i] / deficitSum;
+            int extra = (int)carry;
+            carry -= extra;
+            if (extra > maxSamples - buffer.count[i]) extra = maxSamples - buffer.count[i];
+            buffer.extra[i] = extra;
+            assigned += extra;
+        }
+        if (assigned == 0) break;
+
+        runTiles(settings->width, settings->height, settings->tileSize, settings->threadCount, renderTileAdaptive, &ctx, NULL);
+        used += assigned;
+    }
+
+    for (int i = 0; i < pixelCount; i++) {
+        Vector3 c = buffer.sum[i] * (1.0f / (float)buffer.count[i]);
+        framebuffer[3*i + 0] = c.x;
+        framebuffer[3*i + 1] = c.y;
+        framebuffer[3*i + 2] = c.z;
+    }
+    if (sampleCounts != NULL) sampleCounts->swap(buffer.count);
+}
+
+TracerScene makeTracerScene(const SceneSoA *soa, const BvhView *bvh) {
+    TracerScene scene;
+    scene.soa = soa;
+    scene.lightIntensity = lightIntensity;
+    scene.bvh = bvh;
+    return scene;
+}
+
+TracerSettings defaultTracerSettings(void) {
+    TracerSettings settings;
+    settings.width = 1280;
+    settings.height = 720;
+    settings.samples = 8;
+    settings.maxBounces = 5;
+    settings.time = 0.0f;
+    // Caméra initiale de main.cpp : angleX = angleY = 0, distance_cam = 5, on regarde l'origine
+    settings.viewEye = (Vector3){ 0.0f, 0.0f, 5.0f };
+    settings.viewCenter = (Vector3){ 0.0f, 0.0f, 0.0f };
+    settings.threadCount = 0;
+    settings.tileSize = TILE_SIZE_DEFAULT;
+    settings.packetKernels = selectPacketKernels();
+    settings.wavefront = false;
+    settings.samplerType = SAMPLER_SOBOL;
+    settings.sampleOffset = 0;
+    settings.adaptiveMinSamples = 4;
+    settings.adaptiveMaxSamples = 64;
+    settings.adaptiveThreshold = 0.02f;
+    return settings;
+}
+
+Vector3 toneMapPixel(Vector3 color, int x, int y, int width, int height) {
+    // Tone mapping (ACES)
+    const float a = 2.51f;
+    const float b = 0.03f;
+    const float c = 2.43f;
+    const float d = 0.59f;
+    const float e = 0.14f;
+    float *ch = &color.x;
+    for (int i = 0; i < 3; i++) {
+        float v = ch[i];
+        v = Clamp((v * (a * v + b)) / (v * (c * v + d) + e), 0.0f, 1.0f);
+        // Correction gamma
+        ch[i] = powf(v, 1.0f / 2.2f);
+    }
+
+    // Légère vignette
+    float qx = ((float)x + 0.5f) / (float)width;
+    float qy = ((float)(height - 1 - y) + 0.5f) / (float)height;
+    float vignette = 0.7f + 0.3f * powf(16.0f * qx * qy * (1.0f - qx) * (1.0f - qy), 0.1f);
+    return color * vignette;
+}
+
+bool saveFramebufferPFM(const char *fileName, const float *framebuffer, int width, int height) {
+    FILE *file = fopen(fileName, "wb");
+    if (file == NULL) return false;
+
+    // Échelle négative = little endian, les lignes PFM vont du bas vers le haut
+    fprintf(file, "PF\n%d %d\n-1.0\n", width, height);
+    for (int y = height - 1; y >= 0; y--) {
+        fwrite(framebuffer + 3*y*width, sizeof(float), 3*width, file);
+    }
+    fclose(file);
+    return true;
+}
+
+bool saveFramebufferPPM(const char *fileName, const float *framebuffer, int width, int height) {
+    FILE *file = fopen(fileName, "wb");
+    if (file == NULL) return false;
+
+    fprintf(file, "P6\n%d %d\n255\n", width, height);
+    std::vector<unsigned char> row(3*width);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const float *in = framebuffer + 3*(y*width + x);
+            Vector3 c = toneMapPixel((Vector3){ in[0], in[1], in[2] }, x, y, width, height);
+            row[3*x + 0] = (unsigned char)(Clamp(c.x, 0.0f, 1.0f) * 255.0f + 0.5f);
+            row[3*x + 1] = (unsigned char)(Clamp(c.y, 0.0f, 1.0f) * 255.0f + 0.5f);
+            row[3*x + 2] = (unsigned char)(Clamp(c.z, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+        fwrite(row.data(), 1, row.size(), file);
+    }
+    fclose(file);
+    return true;
+}
@@ -0,0 +1,82 @@
+#ifndef CPU_TRACER_H
+#define CPU_TRACER_H
+
+#include "raylib.h"
+#include "scene.h"
+#include "scene_soa.h"
+#include "bvh.h"
+#include "ray_packet.h"
+#include "sampler.h"
+#include "tile_scheduler.h"
+#include <stddef.h>
+
+#define ADAPTIVE_PASS_SAMPLES 2     // échantillons moyens par pixel actif et par passe
+#define ADAPTIVE_UNIFORM_WEIGHT 0.5f // part uniforme de la répartition (en écarts types moyens)
+
+// Traceur de chemins CPU de référence : portage C++ de trace() / sampleDirectLight() /
+// intersectSphere() / intersectBox() de raytest.fs. Aucune fenêtre ni contexte GL requis.
+
+// Vue sur les données de la scène (les tableaux ne sont pas copiés)
+typedef struct {
+    const SceneSoA *soa;
+    float lightIntensity;
+    const BvhView *bvh;   // NULL = boucles linéaires comme dans raytest.fs
+} TracerScene;
+
+// Paramètres de rendu (équivalents des uniformes et #define de raytest.fs)
+typedef struct {
+    int width;
+    int height;
+    int samples;      // MAX_SAMPLES
+    int maxBounces;   // MAX_BOUNCES
+    float time;       // uniforme time (bruit + motif émissif des murs)
+    Vector3 viewEye;
+    Vector3 viewCenter;
+    int threadCount;  // 0 = tous les coeurs
+    int tileSize;     // côté des tuiles en pixels (TILE_SIZE_MIN .. TILE_SIZE_MAX)
+    const PacketKernels *packetKernels; // rayons caméra par paquets SIMD, NULL = un par un
+    bool wavefront;   // chemins d'une tuile avancés rebond par rebond avec files par matériau
+    int samplerType;  // SAMPLER_HASH, SAMPLER_SOBOL ou SAMPLER_RANK1 (uniforme samplerType)
+    int sampleOffset; // indice du premier échantillon (accumulation sur plusieurs frames)
+    // Échantillonnage adaptatif (renderCpuAdaptive) : budget global samples * pixels
+    int adaptiveMinSamples;   // échantillons initiaux de chaque pixel (au moins 2)
+    int adaptiveMaxSamples;   // plafond par pixel
+    float adaptiveThreshold;  // écart type de la moyenne (tone mappé) sous lequel un pixel n'est plus échantillonné
+} TracerSettings;
+
+// Compteurs de rayons d'un rendu
+typedef struct {
+    long long primaryRays;    // rayons caméra (un par chemin)
+    long long extensionRays;  // segments de chemin, rayons primaires compris
+    long long shadowRays;     // rayons d'ombre de l'échantillonnage direct
+} TracerStats;
+
+// Scène construite sur des tableaux SoA (intensité lumineuse de scene.h) et réglages
+// par défaut identiques à la première frame de main.cpp
+TracerScene makeTracerScene(const SceneSoA *soa, const BvhView *bvh);
+TracerSettings defaultTracerSettings(void);
+
+// Trace un chemin (équivalent de trace() dans raytest.fs), radiance linéaire
+Vector3 tracePath(const TracerScene *scene, const TracerSettings *settings, Vector3 ro, Vector3 rd, float seed, const PathSampler *sampler);
+
+// Rendu complet dans un framebuffer RGB flottant (width*height*3, ligne 0 en haut)
+// en radiance linéaire, avant tone mapping. Les tuiles sont réparties par vol de
+// travail ; tileTimings (optionnel) reçoit le temps de chaque tuile, stats (optionnel)
+// le nombre de rayons tracés.
+void renderCpu(const TracerScene *scene, const TracerSettings *settings, float *framebuffer,
+               std::vector<TileTiming> *tileTimings = NULL, TracerStats *stats = NULL);
+
+// Même budget moyen que renderCpu (settings->samples par pixel) réparti en plusieurs passes
+// vers les pixels dont la variance est forte (verre, caustiques, bords des murs émissifs).
+// Les pixels convergés ne reçoivent plus d'échantillons. sampleCounts (optionnel) reçoit
+// le nombre d'échantillons de chaque pixel.
+void renderCpuAdaptive(const TracerScene *scene, const TracerSettings *settings, float *framebuffer, std::vector<int> *sampleCounts = NULL);
+
+// Tone mapping ACES + gamma + vignette comme à la fin de raytest.fs
+Vector3 toneMapPixel(Vector3 color, int x, int y, int width, int height);
+
+// Écriture du framebuffer : PFM (flottant, linéaire) ou PPM (8 bits, tone mappé)
+bool saveFramebufferPFM(const char *fileName, const float *framebuffer, int width, int height);
+bool saveFramebufferPPM(const char *fileName, const float *framebuffer, int width, int height);
+
+#endif // CPU_TRACER_H
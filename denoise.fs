@@ -4,60 +4,133 @@ in vec2 fragTexCoord;
 out vec4 fragColor;
 
 // Textures d'entrée (liées depuis Raylib avec SetShaderValueTexture)
-uniform sampler2D renderNoisy;     // image bruitée
-uniform sampler2D renderNormals;   // normales + profondeur dans alpha
-uniform sampler2D renderHistory;   // frame précédente
+uniform sampler2D renderNoisy;     // itération 0 : image bruitée (alpha 0 = pas d'échantillon cette frame),
+                                   // ensuite sortie de l'itération précédente (variance dans alpha)
+uniform sampler2D renderNormals;   // normales + profondeur linéaire dans alpha (0 = ciel), G-buffer
+uniform sampler2D renderAlbedo;    // albedo + type de matériau dans alpha (-1 = ciel), G-buffer
+uniform sampler2D renderHistory;   // frame précédente reprojetée, alpha 1 = pixel découvert
 
-// Uniformes
+// Uniformes (voir denoiser.h)
 uniform vec2 resolution;
-uniform float time;
-uniform int frame;
-uniform float u_denoiseStrength; // force du débruitage
+uniform int stepWidth;        // 1, 2, 4, 8, 16 : écart entre les prises du noyau
+uniform int iteration;        // 0 = première itération : variance estimée sur 3x3
+uniform int iterationCount;
+uniform float historyBlend;   // mélange avec l'historique, dernière itération seulement
+uniform float varianceScale;  // 1 / n quand l'entrée est une moyenne de n frames (accumulation)
 
 // Constantes pour le filtre À-Trous
-const float c_phi = 1.0;
-const float n_phi = 128.0;
-const float p_phi = 1.0;
+const float l_phi = 4.0;    // tolérance en écarts types de luminance
+const float n_phi = 128.0;  // exposant sur dot(n, n')
+const float p_phi = 0.05;   // écart de profondeur relatif toléré
+const float a_phi = 0.1;    // écart d'albedo toléré
+
+// Noyau B3 spline 1D : 1/16 1/4 3/8 1/4 1/16
+const float kernel[3] = float[](3.0 / 8.0, 1.0 / 4.0, 1.0 / 16.0);
+
+float luminance(vec3 c) {
+    return dot(c, vec3(0.2126, 0.7152, 0.0722));
+}
+
+// Pixel portant un échantillon : à la première itération, les budgets fractionnaires
+// (raytest.fs) laissent des trous d'alpha 0 que le filtre comble avec les voisins
+bool hasSample(vec4 c) {
+    return iteration > 0 || c.a > 0.0;
+}
+
+// Variance de luminance au pixel : voisinage 3x3 à la première itération (pas de
+// moments temporels), ensuite variance propagée floutée par un noyau gaussien 3x3
+float pixelVariance(vec2 uv, vec2 pixel) {
+    if (iteration == 0) {
+        float sum = 0.0;
+        float sum2 = 0.0;
+        float count = 0.0;
+        for (int i = -1; i <= 1; ++i) {
+            for (int j = -1; j <= 1; ++j) {
+                vec4 c = texture(renderNoisy, uv + vec2(i, j) * pixel);
+                if (!hasSample(c)) continue;
+                float l = luminance(c.rgb);
+                sum += l;
+                sum2 += l * l;
+                count += 1.0;
+            }
+        }
+        if (count < 1.0) return 0.0;
+        float mean = sum / count;
+        return max(sum2 / count - mean * mean, 0.0) * varianceScale;
+    }
+
+    const float gaussian[2] = float[](0.5, 0.25);
+    float variance = 0.0;
+    for (int i = -1; i <= 1; ++i) {
+        for (int j = -1; j <= 1; ++j) {
+            variance += gaussian[abs(i)] * gaussian[abs(j)] * texture(renderNoisy, uv + vec2(i, j) * pixel).a;
+        }
+    }
+    return variance;
+}
 
 void main() {
     vec2 uv = fragTexCoord;
     vec2 pixel = 1.0 / resolution;
 
-    vec3 cval = texture(renderNoisy, uv).rgb;
-    vec3 nval = texture(renderNormals, uv).rgb;
-    float zval = texture(renderNormals, uv).a;
+    vec4 cval = texture(renderNoisy, uv);
+    vec4 nzval = texture(renderNormals, uv);
+    vec3 nval = nzval.rgb;
+    float zval = nzval.a;
+    vec4 aval = texture(renderAlbedo, uv);
 
-    float stepwidth = u_denoiseStrength;
+    bool centerSampled = hasSample(cval);
+    float lval = luminance(cval.rgb);
+    float variance = pixelVariance(uv, pixel);
+    float lumScale = 1.0 / (l_phi * sqrt(variance) + 1e-4);
 
     vec3 sum = vec3(0.0);
+    float sumVariance = 0.0;
     float cum_w = 0.0;
 
     for (int i = -2; i <= 2; ++i) {
         for (int j = -2; j <= 2; ++j) {
-            vec2 offset = vec2(i, j) * stepwidth * pixel;
-            vec2 tc = uv + offset;
+            vec2 tc = uv + vec2(i, j) * float(stepWidth) * pixel;
 
-            vec3 ctmp = texture(renderNoisy, tc).rgb;
-            vec3 ntmp = texture(renderNormals, tc).rgb;
-            float ztmp = texture(renderNormals, tc).a;
+            vec4 ctmp = texture(renderNoisy, tc);
+            vec4 nztmp = texture(renderNormals, tc);
+            vec4 atmp = texture(renderAlbedo, tc);
 
-            float dist2 = dot(ctmp - cval, ctmp - cval);
-            float c_w = min(exp(-dist2 / (c_phi * c_phi)), 1.0);
+            if (!hasSample(ctmp)) continue;
 
-            float n_w = min(exp(-dot(ntmp - nval, ntmp - nval) / (n_phi * n_phi)), 1.0);
-            float r_w = min(exp(-pow(ztmp - zval, 2.0) / (p_phi * p_phi)), 1.0);
+            // Luminance : écart rapporté à l'écart type local (fort lissage là où c'est bruité) ;
+            // sans échantillon au centre, rien à préserver
+            float l_w = centerSampled ? exp(-abs(luminance(ctmp.rgb) - lval) * lumScale) : 1.0;
 
-            float weight = c_w * n_w * r_w;
-            sum += ctmp * weight;
+            // Normales unitaires (nulles pour le ciel : poids 1 entre pixels de ciel)
+            float n_w = (zval > 0.0) ? pow(max(dot(nztmp.rgb, nval), 0.0), n_phi) : 1.0;
+            float dz = (nztmp.a - zval) / max(zval, 1e-3);
+            float r_w = exp(-(dz * dz) / (p_phi * p_phi));
+
+            // Pas de mélange entre matériaux différents ni à travers un changement d'albedo
+            vec3 da = atmp.rgb - aval.rgb;
+            float a_w = (atmp.a == aval.a) ? exp(-dot(da, da) / (a_phi * a_phi)) : 0.0;
+
+            float weight = kernel[abs(i)] * kernel[abs(j)] * l_w * n_w * r_w * a_w;
+            sum += ctmp.rgb * weight;
+            // Variance de la somme pondérée : poids au carré
+            float v = (iteration == 0) ? variance : ctmp.a;
+            sumVariance += weight * weight * v;
             cum_w += weight;
         }
     }
 
-    vec3 colorFiltered = sum / cum_w;
+    // Le pixel central a un poids non nul s'il est échantillonné ; un trou sans voisin
+    // compatible reste noir
+    vec3 colorFiltered = (cum_w > 0.0) ? sum / cum_w : vec3(0.0);
+    float varianceFiltered = (cum_w > 0.0) ? sumVariance / (cum_w * cum_w) : 0.0;
 
-    // Feedback simple avec blending temporel (tu peux ajuster le facteur)
-    vec3 prev = texture(renderHistory, uv).rgb;
-    vec3 blended = mix(colorFiltered, prev, 0.1); // 0.1 = blending léger
+    if (iteration < iterationCount - 1) {
+        fragColor = vec4(colorFiltered, varianceFiltered);
+        return;
+    }
 
-    fragColor = vec4(blended, 1.0);
+    // Feedback simple avec blending temporel ; alpha à 1 car l'historique du TAA y lit son taux de mélange
+    vec4 prev = texture(renderHistory, uv);
+    fragColor = vec4(mix(colorFiltered, prev.rgb, prev.a < 1.0 ? historyBlend : 0.0), 1.0);
 }
@@ -0,0 +1,74 @@
+#include "denoiser.h"
+#include "rlgl.h"
+
+// Noms fixes : GpuTimer garde les pointeurs
+static const char *passNames[DENOISER_MAX_ITERATIONS] = { "atrous_1", "atrous_2", "atrous_4", "atrous_8", "atrous_16" };
+
+bool loadDenoiser(Denoiser *denoiser, Shader shader, RenderPool *pool, int iterations, GpuTimer *timer) {
+    denoiser->shader = shader;
+    setDenoiserIterations(denoiser, iterations);
+    denoiser->varianceScale = 1.0f;
+
+    denoiser->resolutionLoc = GetShaderLocation(shader, "resolution");
+    denoiser->stepWidthLoc = GetShaderLocation(shader, "stepWidth");
+    denoiser->iterationLoc = GetShaderLocation(shader, "iteration");
+    denoiser->iterationCountLoc = GetShaderLocation(shader, "iterationCount");
+    denoiser->historyBlendLoc = GetShaderLocation(shader, "historyBlend");
+    denoiser->varianceScaleLoc = GetShaderLocation(shader, "varianceScale");
+    denoiser->noisyLoc = GetShaderLocation(shader, "renderNoisy");
+    denoiser->normalsLoc = GetShaderLocation(shader, "renderNormals");
+    denoiser->albedoLoc = GetShaderLocation(shader, "renderAlbedo");
+    denoiser->historyLoc = GetShaderLocation(shader, "renderHistory");
+
+    for (int i = 0; i < DENOISER_MAX_ITERATIONS; i++) denoiser->passes[i] = addGpuPass(timer, passNames[i]);
+
+    denoiser->pingPong[0] = addRenderTarget(pool, "denoise_ping", RENDER_TARGET_RGBA16F, TEXTURE_FILTER_BILINEAR);
+    denoiser->pingPong[1] = addRenderTarget(pool, "denoise_pong", RENDER_TARGET_RGBA16F, TEXTURE_FILTER_BILINEAR);
+    return denoiser->pingPong[0] >= 0 && denoiser->pingPong[1] >= 0;
+}
+
+void setDenoiserIterations(Denoiser *denoiser, int iterations) {
+    if (iterations < 0) iterations = 0;
+    if (iterations > DENOISER_MAX_ITERATIONS) iterations = DENOISER_MAX_ITERATIONS;
+    denoiser->iterations = iterations;
+}
+
+Texture2D runDenoiser(Denoiser *denoiser, const RenderPool *pool, const GBuffer *gbuffer, Texture2D input,
+                      Texture2D history, float historyBlend, GpuTimer *timer) {
+    float resolution[2] = { (float)pool->width, (float)pool->height };
+    Rectangle source = { 0.0f, 0.0f, (float)pool->width, -(float)pool->height };
+    Rectangle dest = { 0.0f, 0.0f, (float)pool->width, (float)pool->height };
+
+    for (int i = 0; i < denoiser->iterations; i++) {
+        RenderTexture2D output = getRenderTarget(pool, denoiser->pingPong[i % 2]);
+        int stepWidth = 1 << i;
+        float blend = (i == denoiser->iterations - 1) ? historyBlend : 0.0f;
+
+        beginGpuPass(timer, denoiser->passes[i]);
+        BeginTextureMode(output);
+            // Variance dans alpha : pas de mélange (le batch est vidé par EndShaderMode, avant la réactivation)
+            rlDisableColorBlend();
+            BeginShaderMode(denoiser->shader);
+                SetShaderValue(denoiser->shader, denoiser->resolutionLoc, resolution, SHADER_UNIFORM_VEC2);
+                SetShaderValue(denoiser->shader, denoiser->stepWidthLoc, &stepWidth, SHADER_UNIFORM_INT);
+                SetShaderValue(denoiser->shader, denoiser->iterationLoc, &i, SHADER_UNIFORM_INT);
+                SetShaderValue(denoiser->shader, denoiser->iterationCountLoc, &denoiser->iterations, SHADER_UNIFORM_INT);
+                SetShaderValue(denoiser->shader, denoiser->historyBlendLoc, &blend, SHADER_UNIFORM_FLOAT);
+                SetShaderValue(denoiser->shader, denoiser->varianceScaleLoc, &denoiser->varianceScale, SHADER_UNIFORM_FLOAT);
+
+                // Les textures doivent être liées après BeginShaderMode
+                SetShaderValueTexture(denoiser->shader, denoiser->noisyLoc, input);
+                SetShaderValueTexture(denoiser->shader, denoiser->normalsLoc, gbuffer->normalDepth);
+                SetShaderValueTexture(denoiser->shader, denoiser->albedoLoc, gbuffer->albedoMaterial);
+                SetShaderValueTexture(denoiser->shader, denoiser->historyLoc, history);
+
+                DrawTexturePro(input, source, dest, (Vector2){ 0.0f, 0.0f }, 0.0f, WHITE);
+            EndShaderMode();
+            rlEnableColorBlend();
+        EndTextureMode();
+        endGpuPass(timer);
+
+        input = output.texture;
+    }
+    return input;
+}
@@ -0,0 +1,40 @@
+#ifndef DENOISER_H
+#define DENOISER_H
+
+#include "raylib.h"
+#include "gbuffer.h"
+#include "gpu_timer.h"
+#include "render_pool.h"
+
+// Débruitage à-trous (ondelettes avec arrêt aux bords, style SVGF) : chaque itération
+// applique denoise.fs avec un noyau B3 5x5 dont le pas double (1, 2, 4, 8, 16), en
+// alternant entre deux cibles RGBA16F. Les poids combinent luminance guidée par la
+// variance, normale, profondeur et albedo du G-buffer. La variance de luminance est
+// estimée sur 3x3 à la première itération puis filtrée avec les carrés des poids ;
+// elle voyage dans l'alpha des cibles intermédiaires.
+
+#define DENOISER_MAX_ITERATIONS 5
+
+typedef struct {
+    Shader shader;
+    int pingPong[2];                        // cibles RGBA16F du RenderPool
+    int iterations;                         // 0 = pas de débruitage
+    int passes[DENOISER_MAX_ITERATIONS];    // une passe GpuTimer par itération
+    float varianceScale;                    // 1 / n pour une moyenne de n frames (accumulation), sinon 1
+
+    int resolutionLoc, stepWidthLoc, iterationLoc, iterationCountLoc, historyBlendLoc, varianceScaleLoc;
+    int noisyLoc, normalsLoc, albedoLoc, historyLoc;
+} Denoiser;
+
+// Les cibles appartiennent au pool (libérées et réallouées avec lui)
+bool loadDenoiser(Denoiser *denoiser, Shader shader, RenderPool *pool, int iterations, GpuTimer *timer);
+
+void setDenoiserIterations(Denoiser *denoiser, int iterations);
+
+// Lance la chaîne sur input (couleur du G-buffer ou moyenne accumulée) ; la dernière
+// itération mélange historyBlend de l'historique. Renvoie la texture résultat (input si
+// iterations == 0), valide jusqu'au prochain appel.
+Texture2D runDenoiser(Denoiser *denoiser, const RenderPool *pool, const GBuffer *gbuffer, Texture2D input,
+                      Texture2D history, float historyBlend, GpuTimer *timer);
+
+#endif // DENOISER_H
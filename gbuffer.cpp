@@ -0,0 +1,105 @@
+#include "gbuffer.h"
+#include "rlgl.h"
+#include <stddef.h>
+#include <stdlib.h>
+
+// data : contenu initial (NULL = indéfini)
+static Texture2D loadFloatTexture(const void *data, int width, int height, int format) {
+    Texture2D texture = { 0 };
+    texture.id = rlLoadTexture(data, width, height, format, 1);
+    texture.width = width;
+    texture.height = height;
+    texture.mipmaps = 1;
+    texture.format = format;
+    if (texture.id == 0) return texture;
+    // Pas d'interpolation entre une surface et le ciel
+    SetTextureFilter(texture, TEXTURE_FILTER_POINT);
+    return texture;
+}
+
+static Texture2D loadFloatAttachment(unsigned int framebuffer, int attachment, int width, int height) {
+    Texture2D texture = loadFloatTexture(NULL, width, height, PIXELFORMAT_UNCOMPRESSED_R16G16B16A16);
+    if (texture.id == 0) return texture;
+    rlFramebufferAttach(framebuffer, texture.id, attachment, RL_ATTACHMENT_TEXTURE2D, 0);
+    return texture;
+}
+
+bool loadGBuffer(GBuffer *gbuffer, int width, int height) {
+    gbuffer->target = loadFloatRenderTexture(width, height, PIXELFORMAT_UNCOMPRESSED_R16G16B16A16);
+    gbuffer->normalDepth = (Texture2D){ 0 };
+    gbuffer->prevNormalDepth = (Texture2D){ 0 };
+    gbuffer->albedoMaterial = (Texture2D){ 0 };
+    gbuffer->motion = (Texture2D){ 0 };
+    if (gbuffer->target.id == 0) return false;
+
+    gbuffer->normalDepth = loadFloatAttachment(gbuffer->target.id, RL_ATTACHMENT_COLOR_CHANNEL1, width, height);
+    gbuffer->albedoMaterial = loadFloatAttachment(gbuffer->target.id, RL_ATTACHMENT_COLOR_CHANNEL2, width, height);
+    gbuffer->motion = loadFloatAttachment(gbuffer->target.id, RL_ATTACHMENT_COLOR_CHANNEL3, width, height);
+    // Même format, attachée à tour de rôle par swapGBufferHistory. Remplie de zéros (ciel
+    // partout) : avant la première frame, la reprojection ne lit pas de mémoire indéfinie
+    void *zeros = calloc((size_t)width * height, 4 * sizeof(unsigned short));
+    if (zeros != NULL) {
+        gbuffer->prevNormalDepth = loadFloatTexture(zeros, width, height, PIXELFORMAT_UNCOMPRESSED_R16G16B16A16);
+        free(zeros);
+    }
+
+    // La liste des draw buffers fait partie de l'état du framebuffer : réglée une fois
+    rlEnableFramebuffer(gbuffer->target.id);
+    rlActiveDrawBuffers(4);
+    rlDisableFramebuffer();
+
+    bool complete = gbuffer->normalDepth.id != 0 && gbuffer->albedoMaterial.id != 0 && gbuffer->motion.id != 0
+                 && gbuffer->prevNormalDepth.id != 0 && rlFramebufferComplete(gbuffer->target.id);
+    if (!complete) {
+        TraceLog(LOG_ERROR, "GBUFFER: framebuffer %dx%d incomplet", width, height);
+        unloadGBuffer(gbuffer);
+        return false;
+    }
+    return true;
+}
+
+void unloadGBuffer(GBuffer *gbuffer) {
+    if (gbuffer->normalDepth.id != 0) UnloadTexture(gbuffer->normalDepth);
+    if (gbuffer->prevNormalDepth.id != 0) UnloadTexture(gbuffer->prevNormalDepth);
+    if (gbuffer->albedoMaterial.id != 0) UnloadTexture(gbuffer->albedoMaterial);
+    if (gbuffer->motion.id != 0) UnloadTexture(gbuffer->motion);
+    if (gbuffer->target.id != 0) UnloadRenderTexture(gbuffer->target);
+    gbuffer->normalDepth = (Texture2D){ 0 };
+    gbuffer->prevNormalDepth = (Texture2D){ 0 };
+    gbuffer->albedoMaterial = (Texture2D){ 0 };
+    gbuffer->motion = (Texture2D){ 0 };
+    gbuffer->target = (RenderTexture2D){ 0 };
+}
+
+void swapGBufferHistory(GBuffer *gbuffer) {
+    Texture2D previous = gbuffer->normalDepth;
+    gbuffer->normalDepth = gbuffer->prevNormalDepth;
+    gbuffer->prevNormalDepth = previous;
+    rlDrawRenderBatchActive();
+    rlFramebufferAttach(gbuffer->target.id, gbuffer->normalDepth.id, RL_ATTACHMENT_COLOR_CHANNEL1, RL_ATTACHMENT_TEXTURE2D, 0);
+}
+
+RenderTexture2D loadFloatRenderTexture(int width, int height, int format) {
+    RenderTexture2D target = { 0 };
+    target.id = rlLoadFramebuffer();
+    if (target.id == 0) return target;
+    target.texture = loadFloatTexture(NULL, width, height, format);
+    if (target.texture.id != 0) rlFramebufferAttach(target.id, target.texture.id, RL_ATTACHMENT_COLOR_CHANNEL0, RL_ATTACHMENT_TEXTURE2D, 0);
+    if (target.texture.id == 0 || !rlFramebufferComplete(target.id)) {
+        TraceLog(LOG_ERROR, "GBUFFER: cible flottante %dx%d impossible", width, height);
+        if (target.texture.id != 0) UnloadTexture(target.texture);
+        rlUnloadFramebuffer(target.id);
+        return (RenderTexture2D){ 0 };
+    }
+    return target;
+}
+
+void beginGBufferWrite(void) {
+    rlDrawRenderBatchActive();
+    rlDisableColorBlend();
+}
+
+void endGBufferWrite(void) {
+    rlDrawRenderBatchActive();
+    rlEnableColorBlend();
+}
@@ -0,0 +1,41 @@
+#ifndef GBUFFER_H
+#define GBUFFER_H
+
+#include "raylib.h"
+
+// Cible de la passe de raytracing : raytest.fs écrit dans la même passe
+//   attachement 0 : radiance linéaire HDR (RGBA16F, sans tone mapping)
+//   attachement 1 : normale du premier impact (xyz) et profondeur linéaire (w, 0 = ciel), RGBA16F
+//   attachement 2 : albedo (xyz) et type de matériau (w, -1 = ciel), RGBA16F
+//   attachement 3 : vecteur de mouvement uv courant - uv précédent (xy), profondeur
+//                   attendue dans la caméra précédente (z, 0 = ciel), 1 si reprojetable (w), RGBA16F
+// Le débruiteur s'en sert pour ses fonctions d'arrêt aux bords, reproject.fs pour
+// retrouver l'historique et rejeter les pixels découverts.
+typedef struct {
+    RenderTexture2D target;     // framebuffer complet, utilisable avec BeginTextureMode
+    Texture2D normalDepth;
+    Texture2D prevNormalDepth;  // normalDepth de la frame précédente (détachée)
+    Texture2D albedoMaterial;
+    Texture2D motion;
+} GBuffer;
+
+// Couleur, normalDepth, prevNormalDepth, albedoMaterial et motion en RGBA16F, sans profondeur
+#define GBUFFER_BYTES_PER_PIXEL (5 * 8)
+
+bool loadGBuffer(GBuffer *gbuffer, int width, int height);
+void unloadGBuffer(GBuffer *gbuffer);
+
+// À appeler avant la passe de raytracing : normalDepth devient prevNormalDepth et
+// l'ancienne texture précédente est attachée pour être réécrite (pas de copie)
+void swapGBufferHistory(GBuffer *gbuffer);
+
+// Le mélange alpha s'appliquerait aussi aux attachements 1 à 3 (profondeur, type et validité
+// dans alpha) : à encadrer autour du dessin de la passe de raytracing
+void beginGBufferWrite(void);
+void endGBufferWrite(void);
+
+// Cible flottante sans tampon de profondeur (passes plein écran de la chaîne HDR),
+// format PIXELFORMAT_UNCOMPRESSED_R16G16B16A16 ou R32G32B32A32
+RenderTexture2D loadFloatRenderTexture(int width, int height, int format);
+
+#endif // GBUFFER_H
@@ -0,0 +1,8 @@
+#include "gl_loader.h"
+
+// Fourni par GLFW, lié dans raylib
+extern "C" void *glfwGetProcAddress(const char *procname);
+
+void *loadGlFunction(const char *name) {
+    return glfwGetProcAddress(name);
+}
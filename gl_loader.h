@@ -0,0 +1,16 @@
+#ifndef GL_LOADER_H
+#define GL_LOADER_H
+
+// Fonctions OpenGL absentes de rlgl (raylib n'expose pas les en-têtes GL) : chargées à
+// la demande dans le contexte courant, à appeler après InitWindow.
+
+#if defined(_WIN32) && !defined(_WIN64)
+    #define GL_LOADER_APIENTRY __stdcall
+#else
+    #define GL_LOADER_APIENTRY
+#endif
+
+// Adresse de la fonction GL nommée, NULL si le pilote ne la fournit pas
+void *loadGlFunction(const char *name);
+
+#endif // GL_LOADER_H
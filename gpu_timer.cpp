@@ -0,0 +1,199 @@
+#include "gpu_timer.h"
+#include "gl_loader.h"
+#include "raylib.h"
+#include "rlgl.h"
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+
+// Constantes OpenGL 3.3 (raylib n'expose pas les en-têtes GL)
+#define GL_TIME_ELAPSED 0x88BF
+#define GL_QUERY_RESULT 0x8866
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+
+typedef void (GL_LOADER_APIENTRY *GenQueriesProc)(int n, unsigned int *ids);
+typedef void (GL_LOADER_APIENTRY *DeleteQueriesProc)(int n, const unsigned int *ids);
+typedef void (GL_LOADER_APIENTRY *BeginQueryProc)(unsigned int target, unsigned int id);
+typedef void (GL_LOADER_APIENTRY *EndQueryProc)(unsigned int target);
+typedef void (GL_LOADER_APIENTRY *GetQueryObjectivProc)(unsigned int id, unsigned int pname, int *params);
+typedef void (GL_LOADER_APIENTRY *GetQueryObjectui64vProc)(unsigned int id, unsigned int pname, uint64_t *params);
+
+static GenQueriesProc glGenQueriesPtr = NULL;
+static DeleteQueriesProc glDeleteQueriesPtr = NULL;
+static BeginQueryProc glBeginQueryPtr = NULL;
+static EndQueryProc glEndQueryPtr = NULL;
+static GetQueryObjectivProc glGetQueryObjectivPtr = NULL;
+static GetQueryObjectui64vProc glGetQueryObjectui64vPtr = NULL;
+
+static bool loadQueryFunctions(void) {
+    glGenQueriesPtr = (GenQueriesProc)loadGlFunction("glGenQueries");
+    glDeleteQueriesPtr = (DeleteQueriesProc)loadGlFunction("glDeleteQueries");
+    glBeginQueryPtr = (BeginQueryProc)loadGlFunction("glBeginQuery");
+    glEndQueryPtr = (EndQueryProc)loadGlFunction("glEndQuery");
+    glGetQueryObjectivPtr = (GetQueryObjectivProc)loadGlFunction("glGetQueryObjectiv");
+    glGetQueryObjectui64vPtr = (GetQueryObjectui64vProc)loadGlFunction("glGetQueryObjectui64v");
+    return glGenQueriesPtr && glDeleteQueriesPtr && glBeginQueryPtr && glEndQueryPtr
+           && glGetQueryObjectivPtr && glGetQueryObjectui64vPtr;
+}
+
+bool initGpuTimer(GpuTimer *timer) {
+    memset(timer, 0, sizeof(*timer));
+    timer->activePass = -1;
+    timer->lastFrameMs = -1.0f;
+    timer->supported = loadQueryFunctions();
+    if (!timer->supported) TraceLog(LOG_WARNING, "GPU TIMER: requetes GL_TIME_ELAPSED indisponibles");
+    return timer->supported;
+}
+
+void unloadGpuTimer(GpuTimer *timer) {
+    stopGpuTimerLog(timer);
+    if (timer->supported) {
+        for (int p = 0; p < timer->passCount; p++) glDeleteQueriesPtr(GPU_TIMER_LATENCY, timer->passes[p].queries);
+    }
+    timer->passCount = 0;
+}
+
+int addGpuPass(GpuTimer *timer, const char *name) {
+    if (timer->passCount >= GPU_TIMER_MAX_PASSES) return -1;
+    GpuPassTimer *pass = &timer->passes[timer->passCount];
+    memset(pass, 0, sizeof(*pass));
+    pass->name = name;
+    pass->lastMs = -1.0f;
+    if (timer->supported) glGenQueriesPtr(GPU_TIMER_LATENCY, pass->queries);
+    return timer->passCount++;
+}
+
+void beginGpuPass(GpuTimer *timer, int pass) {
+    if (!timer->supported || pass < 0 || pass >= timer->passCount || timer->activePass >= 0) return;
+    rlDrawRenderBatchActive();
+    glBeginQueryPtr(GL_TIME_ELAPSED, timer->passes[pass].queries[timer->slot]);
+    timer->passes[pass].issued[timer->slot] = true;
+    timer->activePass = pass;
+}
+
+void endGpuPass(GpuTimer *timer) {
+    if (!timer->supported || timer->activePass < 0) return;
+    rlDrawRenderBatchActive();
+    glEndQueryPtr(GL_TIME_ELAPSED);
+    timer->activePass = -1;
+}
+
+// min / moyenne / p99 sur l'historique de la passe
+static void updatePassStats(GpuPassTimer *pass) {
+    float sorted[GPU_TIMER_HISTORY];
+    int n = pass->historyCount;
+    if (n == 0) return;
+
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) {
+        sorted[i] = pass->history[i];
+        sum += sorted[i];
+    }
+    std::sort(sorted, sorted + n);
+    pass->minMs = sorted[0];
+    pass->avgMs = (float)(sum / n);
+    int p99 = (99*n + 99) / 100 - 1;  // rang ceil(0.99 n)
+    pass->p99Ms = sorted[p99 < 0 ? 0 : p99];
+}
+
+void endGpuFrame(GpuTimer *timer) {
+    if (!timer->supported) return;
+    if (timer->activePass >= 0) endGpuPass(timer);
+
+    // Le jeu suivant contient les requêtes de la frame précédente
+    timer->slot = (timer->slot + 1) % GPU_TIMER_LATENCY;
+    long long resultFrame = timer->frame - (GPU_TIMER_LATENCY - 1);
+    timer->frame++;
+
+    bool anyResult = false;
+    float totalMs = 0.0f;
+    for (int p = 0; p < timer->passCount; p++) {
+        GpuPassTimer *pass = &timer->passes[p];
+        pass->lastMs = -1.0f;
+        if (!pass->issued[timer->slot]) continue;
+
+        unsigned int query = pass->queries[timer->slot];
+        int available = 0;
+        glGetQueryObjectivPtr(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) timer->stalls++;  // la lecture ci-dessous attendra le GPU
+
+        uint64_t elapsedNs = 0;
+        glGetQueryObjectui64vPtr(query, GL_QUERY_RESULT, &elapsedNs);
+        pass->issued[timer->slot] = false;
+
+        pass->lastMs = (float)((double)elapsedNs * 1e-6);
+        pass->history[pass->historyHead] = pass->lastMs;
+        pass->historyHead = (pass->historyHead + 1) % GPU_TIMER_HISTORY;
+        if (pass->historyCount < GPU_TIMER_HISTORY) pass->historyCount++;
+        updatePassStats(pass);
+
+        totalMs += pass->lastMs;
+        anyResult = true;
+    }
+    timer->lastFrameMs = anyResult ? totalMs : -1.0f;
+
+    if (timer->log != NULL && anyResult) {
+        fprintf(timer->log, "%lld", resultFrame);
+        for (int p = 0; p < timer->passCount; p++) {
+            if (timer->passes[p].lastMs >= 0.0f) fprintf(timer->log, ",%.4f", timer->passes[p].lastMs);
+            else fprintf(timer->log, ",");
+        }
+        fprintf(timer->log, ",%.4f\n", totalMs);
+    }
+}
+
+bool startGpuTimerLog(GpuTimer *timer, const char *fileName) {
+    stopGpuTimerLog(timer);
+    timer->log = fopen(fileName, "w");
+    if (timer->log == NULL) {
+        TraceLog(LOG_WARNING, "GPU TIMER: impossible d'ouvrir %s", fileName);
+        return false;
+    }
+    fprintf(timer->log, "frame");
+    for (int p = 0; p < timer->passCount; p++) fprintf(timer->log, ",%s_ms", timer->passes[p].name);
+    fprintf(timer->log, ",total_ms\n");
+    return true;
+}
+
+void stopGpuTimerLog(GpuTimer *timer) {
+    if (timer->log != NULL) fclose(timer->log);
+    timer->log = NULL;
+}
+
+// Police proportionnelle : une colonne par valeur
+static void drawTimingRow(const char *name, float last, float minMs, float avgMs, float p99Ms, int x, int y, Color color) {
+    DrawText(name, x, y, 20, color);
+    DrawText(last >= 0.0f ? TextFormat("%.3f", last) : "-", x + 150, y, 20, color);
+    DrawText(TextFormat("%.3f", minMs), x + 230, y, 20, color);
+    DrawText(TextFormat("%.3f", avgMs), x + 310, y, 20, color);
+    DrawText(TextFormat("%.3f", p99Ms), x + 390, y, 20, color);
+}
+
+void drawGpuTimerOverlay(const GpuTimer *timer, int x, int y) {
+    const int lineHeight = 20;
+    if (!timer->supported) {
+        DrawText("GPU timer: unsupported", x, y, 20, WHITE);
+        return;
+    }
+
+    DrawText("GPU pass (ms)", x, y, 20, WHITE);
+    DrawText("last", x + 150, y, 20, WHITE);
+    DrawText("min", x + 230, y, 20, WHITE);
+    DrawText("avg", x + 310, y, 20, WHITE);
+    DrawText("p99", x + 390, y, 20, WHITE);
+
+    float totalAvg = 0.0f;
+    for (int p = 0; p < timer->passCount; p++) {
+        const GpuPassTimer *pass = &timer->passes[p];
+        y += lineHeight;
+        if (pass->historyCount == 0) {
+            DrawText(pass->name, x, y, 20, GRAY);
+            continue;
+        }
+        drawTimingRow(pass->name, pass->lastMs, pass->minMs, pass->avgMs, pass->p99Ms, x, y, WHITE);
+        totalAvg += pass->avgMs;
+    }
+    y += lineHeight;
+    DrawText(TextFormat("total (avg) %.3f ms, stalls %d%s", totalAvg, timer->stalls, timer->log ? ", logging" : ""),
+             x, y, 20, WHITE);
+}
@@ -0,0 +1,62 @@
+#ifndef GPU_TIMER_H
+#define GPU_TIMER_H
+
+#include <stdio.h>
+
+// Mesure du temps GPU de chaque passe avec des requêtes GL_TIME_ELAPSED.
+// Les requêtes sont doublées : celles de la frame N sont lues à la fin de la frame
+// N+1, quand le GPU les a terminées, pour ne pas bloquer le pipeline.
+// Les fonctions de requête (GL 3.3) sont chargées avec loadGlFunction (gl_loader.h) ; si elles
+// manquent, supported reste à false et toutes les fonctions ne font rien.
+
+#define GPU_TIMER_MAX_PASSES 16
+#define GPU_TIMER_LATENCY 2         // jeux de requêtes en vol
+#define GPU_TIMER_HISTORY 240       // frames gardées pour min / moyenne / p99
+
+typedef struct {
+    const char *name;
+    unsigned int queries[GPU_TIMER_LATENCY];
+    bool issued[GPU_TIMER_LATENCY];   // requête lancée pendant la frame de ce jeu
+    float history[GPU_TIMER_HISTORY]; // durées en ms (tampon circulaire)
+    int historyCount;
+    int historyHead;
+    float lastMs;                     // -1 si la passe n'a pas tourné dans la dernière frame lue
+    float minMs, avgMs, p99Ms;
+} GpuPassTimer;
+
+typedef struct {
+    bool supported;
+    int passCount;
+    GpuPassTimer passes[GPU_TIMER_MAX_PASSES];
+    int slot;               // jeu de requêtes de la frame courante
+    int activePass;         // -1 hors passe (GL_TIME_ELAPSED ne s'imbrique pas)
+    long long frame;        // numéro de la frame courante
+    int stalls;             // lectures où le résultat n'était pas encore prêt
+    float lastFrameMs;      // somme des passes de la dernière frame lue, -1 si aucune
+    FILE *log;              // CSV, NULL si désactivé
+} GpuTimer;
+
+// À appeler après InitWindow (contexte GL courant)
+bool initGpuTimer(GpuTimer *timer);
+void unloadGpuTimer(GpuTimer *timer);
+
+// Déclare une passe, renvoie son indice (-1 si GPU_TIMER_MAX_PASSES est atteint)
+int addGpuPass(GpuTimer *timer, const char *name);
+
+// Encadrent un bloc BeginTextureMode / EndTextureMode ; le batch raylib est vidé
+// aux deux bornes pour que ses commandes tombent dans la bonne requête
+void beginGpuPass(GpuTimer *timer, int pass);
+void endGpuPass(GpuTimer *timer);
+
+// Fin de frame : lit les requêtes de la frame précédente, met à jour les
+// statistiques et écrit une ligne dans le log
+void endGpuFrame(GpuTimer *timer);
+
+// Log CSV (frame, une colonne par passe en ms, total) ; vide si la passe n'a pas tourné
+bool startGpuTimerLog(GpuTimer *timer, const char *fileName);
+void stopGpuTimerLog(GpuTimer *timer);
+
+// Tableau passe / dernière / min / moy / p99
+void drawGpuTimerOverlay(const GpuTimer *timer, int x, int y);
+
+#endif // GPU_TIMER_H
@@ -0,0 +1,190 @@
+// Rendu sans fenêtre ni contexte GL : utilise le traceur CPU (cpu_tracer.cpp)
+// sur la même scène que main.cpp et écrit l'image dans un fichier.
+//
+// Utilisation : ./headless [-w largeur] [-h hauteur] [-s échantillons] [-b rebonds]
+//                          [-t threads] [--time secondes] [--linear] [--simd auto|avx2|sse|scalar|off]
+//                          [--tile taille] [--tile-stats tuiles.csv] [--wavefront]
+//                          [--adaptive seuil] [--adaptive-max n] [--sample-map carte.pgm]
+//                          [--sampler sobol|rank1|hash] [--scene scene.rtscene] [-o sortie.ppm|sortie.pfm]
+//
+// --linear désactive le BVH et reprend les boucles linéaires de raytest.fs.
+// --simd choisit les noyaux des paquets de rayons caméra (auto = CPUID, off = un rayon à la fois).
+// --tile règle la taille des tuiles (16 à 64), --tile-stats écrit le temps de chaque tuile.
+// --wavefront avance les chemins d'une tuile rebond par rebond (files par matériau).
+// --adaptive répartit le même budget (-s par pixel en moyenne) selon la variance de chaque pixel,
+// --sample-map écrit alors le nombre d'échantillons par pixel en niveaux de gris.
+// --sampler choisit la suite des tirages (Sobol-Owen par défaut, hash = bruit blanc historique).
+// --scene rend un fichier de scène binaire (scene_convert) avec sa caméra, sa lumière et son BVH.
+#include "cpu_tracer.h"
+#include "scene_file.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+static void printUsage(const char *program) {
+    printf("Utilisation : %s [-w largeur] [-h hauteur] [-s echantillons] [-b rebonds]\n", program);
+    printf("                 [-t threads] [--time secondes] [--linear] [--simd auto|avx2|sse|scalar|off]\n");
+    printf("                 [--tile taille] [--tile-stats tuiles.csv] [--wavefront]\n");
+    printf("                 [--adaptive seuil] [--adaptive-max n] [--sample-map carte.pgm]\n");
+    printf("                 [--sampler sobol|rank1|hash] [--scene scene.rtscene] [-o sortie.ppm|sortie.pfm]\n");
+}
+
+static bool endsWith(const char *str, const char *suffix) {
+    size_t n = strlen(str), m = strlen(suffix);
+    return n >= m && strcmp(str + n - m, suffix) == 0;
+}
+
+// Carte du nombre d'échantillons (blanc = maxSamples)
+static bool saveSampleMapPGM(const char *fileName, const std::vector<int> &counts, int width, int height, int maxSamples) {
+    FILE *file = fopen(fileName, "wb");
+    if (file == NULL) return false;
+
+    fprintf(file, "P5\n%d %d\n255\n", width, height);
+    std::vector<unsigned char> row(width);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int v = counts[y*width + x] * 255 / maxSamples;
+            row[x] = (unsigned char)(v > 255 ? 255 : v);
+        }
+        fwrite(row.data(), 1, width, file);
+    }
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    TracerSettings settings = defaultTracerSettings();
+    const char *output = "render.ppm";
+    const char *tileStatsFile = NULL;
+    const char *sampleMapFile = NULL;
+    const char *sceneFileName = NULL;
+    bool adaptive = false;
+    bool useBvh = true;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (strcmp(arg, "-w") == 0 && hasValue) settings.width = atoi(argv[++i]);
+        else if (strcmp(arg, "-h") == 0 && hasValue) settings.height = atoi(argv[++i]);
+        else if (strcmp(arg, "-s") == 0 && hasValue) settings.samples = atoi(argv[++i]);
+        else if (strcmp(arg, "-b") == 0 && hasValue) settings.maxBounces = atoi(argv[++i]);
+        else if (strcmp(arg, "-t") == 0 && hasValue) settings.threadCount = atoi(argv[++i]);
+        else if (strcmp(arg, "--time") == 0 && hasValue) settings.time = (float)atof(argv[++i]);
+        else if (strcmp(arg, "-o") == 0 && hasValue) output = argv[++i];
+        else if (strcmp(arg, "--tile") == 0 && hasValue) settings.tileSize = atoi(argv[++i]);
+        else if (strcmp(arg, "--tile-stats") == 0 && hasValue) tileStatsFile = argv[++i];
+        else if (strcmp(arg, "--linear") == 0) useBvh = false;
+        else if (strcmp(arg, "--scene") == 0 && hasValue) sceneFileName = argv[++i];
+        else if (strcmp(arg, "--wavefront") == 0) settings.wavefront = true;
+        else if (strcmp(arg, "--adaptive") == 0 && hasValue) {
+            adaptive = true;
+            settings.adaptiveThreshold = (float)atof(argv[++i]);
+        }
+        else if (strcmp(arg, "--adaptive-max") == 0 && hasValue) settings.adaptiveMaxSamples = atoi(argv[++i]);
+        else if (strcmp(arg, "--sample-map") == 0 && hasValue) sampleMapFile = argv[++i];
+        else if (strcmp(arg, "--sampler") == 0 && hasValue) {
+            settings.samplerType = findSamplerType(argv[++i]);
+            if (settings.samplerType < 0) {
+                fprintf(stderr, "Echantillonneur '%s' inconnu\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (strcmp(arg, "--simd") == 0 && hasValue) {
+            const char *name = argv[++i];
+            settings.packetKernels = (strcmp(name, "off") == 0) ? NULL : findPacketKernels(name);
+            if (settings.packetKernels == NULL && strcmp(name, "off") != 0) {
+                fprintf(stderr, "Noyaux SIMD '%s' inconnus ou non supportes par ce processeur\n", name);
+                return 1;
+            }
+        }
+        else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (settings.width <= 0 || settings.height <= 0 || settings.samples <= 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    SceneSoA soa;
+    SceneFile sceneFile;
+    Bvh bvh;            // construit quand le fichier n'a pas de BVH
+    BvhView bvhView = { NULL, 0, NULL, 0 };
+    if (sceneFileName != NULL) {
+        std::chrono::steady_clock::time_point loadStart = std::chrono::steady_clock::now();
+        if (!loadSceneFile(&sceneFile, sceneFileName)) return 1;
+        soa = sceneFile.soa;
+        if (useBvh && sceneFile.bvh.nodeCount > 0) bvhView = sceneFile.bvh;
+        else if (useBvh) {
+            buildBvh(&bvh, &soa);
+            bvhView = makeBvhView(&bvh);
+        }
+        settings.viewEye = sceneFile.info.cameraEye;
+        settings.viewCenter = sceneFile.info.cameraTarget;
+        printf("Scene %s : %d spheres, %d blocs, %d triangles, chargee en %.2f ms\n", sceneFileName, soa.sphereCount,
+               soa.blockCount, soa.triangleCount, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count());
+    }
+    else {
+        if (!loadSceneSoAFromArrays(&soa, spheres, materials, MAX_SPHERES, blocks, materials_block, MAX_BLOCKS)) {
+            fprintf(stderr, "Allocation de la scene impossible\n");
+            return 1;
+        }
+        if (useBvh) {
+            buildBvh(&bvh, &soa);
+            bvhView = makeBvhView(&bvh);
+        }
+    }
+    TracerScene scene = makeTracerScene(&soa, useBvh ? &bvhView : NULL);
+    if (sceneFileName != NULL) scene.lightIntensity = sceneFile.info.lightIntensity;
+
+    std::vector<float> framebuffer(3*settings.width*settings.height);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<TileTiming> tileTimings;
+    std::vector<int> sampleCounts;
+    if (adaptive) renderCpuAdaptive(&scene, &settings, framebuffer.data(), &sampleCounts);
+    else renderCpu(&scene, &settings, framebuffer.data(), &tileTimings);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    printf("Rendu %dx%d, %d echantillons/pixel (%s), paquets %s%s : %.1f ms\n", settings.width, settings.height, settings.samples,
+           samplerTypeName(settings.samplerType), settings.packetKernels ? settings.packetKernels->name : "off",
+           settings.wavefront ? ", wavefront" : "", ms);
+    printTileStats(tileTimings);
+    if (adaptive) {
+        long long total = 0;
+        int minCount = sampleCounts[0], maxCount = sampleCounts[0], converged = 0;
+        for (size_t i = 0; i < sampleCounts.size(); i++) {
+            total += sampleCounts[i];
+            if (sampleCounts[i] < minCount) minCount = sampleCounts[i];
+            if (sampleCounts[i] > maxCount) maxCount = sampleCounts[i];
+            if (sampleCounts[i] <= settings.adaptiveMinSamples) converged++;
+        }
+        printf("Adaptatif (seuil %.3f) : %.2f echantillons/pixel en moyenne, min %d, max %d, %d pixels arretes apres la passe initiale\n",
+               settings.adaptiveThreshold, (double)total / sampleCounts.size(), minCount, maxCount, converged);
+        if (sampleMapFile != NULL && !saveSampleMapPGM(sampleMapFile, sampleCounts, settings.width, settings.height, settings.adaptiveMaxSamples)) {
+            fprintf(stderr, "Impossible d'ecrire %s\n", sampleMapFile);
+        }
+    }
+    if (tileStatsFile != NULL && !saveTileStatsCSV(tileStatsFile, tileTimings)) {
+        fprintf(stderr, "Impossible d'ecrire %s\n", tileStatsFile);
+    }
+
+    bool saved = endsWith(output, ".pfm")
+        ? saveFramebufferPFM(output, framebuffer.data(), settings.width, settings.height)
+        : saveFramebufferPPM(output, framebuffer.data(), settings.width, settings.height);
+    if (!saved) {
+        fprintf(stderr, "Impossible d'ecrire %s\n", output);
+        if (sceneFileName != NULL) unloadSceneFile(&sceneFile);
+        else unloadSceneSoA(&soa);
+        return 1;
+    }
+
+    if (sceneFileName != NULL) unloadSceneFile(&sceneFile);
+    else unloadSceneSoA(&soa);
+
+    return 0;
+}
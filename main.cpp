@@ -4,8 +4,24 @@
 #include "raygui.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <vector>
 
+#include "scene.h"
+#include "bvh.h"
+#include "scene_soa.h"
+#include "sampler.h"
+#include "gpu_timer.h"
+#include "scene_uploader.h"
+#include "scene_file.h"
+#include "scene_mesh.h"
+#include "gbuffer.h"
+#include "denoiser.h"
+#include "render_pool.h"
+#include "accumulator.h"
+#include "resolution_controller.h"
+#include "sample_budget.h"
+
 #define RLIGHTS_IMPLEMENTATION
 #if defined(_WIN32) || defined(_WIN64)
 #include "include/shaders/rlights.h"
@@ -27,95 +43,39 @@ float distance_cam = 5.0f;
 // Variable pour activer/désactiver la rotation
 bool isRotating = false;
 
-#define MAX_SPHERES 2
-#define MAX_BLOCKS 6
-
-// Structure pour les sphères
-typedef struct {
-    Vector3 position;
-    float radius;
-} Sphere;
-
-//structure pour les blocs (murs)
-typedef struct {
-    Vector3 position;
-    Vector3 size; // Taille du bloc (largeur, hauteur, profondeur)
-} Block;
-
-// Structure pour les matériaux
-typedef struct {
-    int type;         // 0 = diffus, 1 = métallique, 2 = verre, 3 = emissif
-    float roughness;  // 0.0 - 1.0
-    float ior;        // indice de réfraction (verre)
-    float padding;    // pour alignement
-    Vector3 albedo;   // couleur
-    float padding2;   // pour alignement
-} Material2;
-
-// Données des sphères
-Sphere spheres[MAX_SPHERES] = {
-    {{0.0f, 0.0f, 0.0f}, 1.0f},     // Sphère centrale
-    {{1.5f, 0.0f, 1.5f}, 0.5f}      // Petite sphère
-    //{{-2.5f, 0.0f, 0.0f}, 1.0f},    // Sphère à gauche
-    //{{2.5f, 0.0f, 0.0f}, 1.0f},     // Sphère à droite
-    //{{0.0f, -1001.0f, 0.0f}, 1000.0f}, // Sol (grosse sphère en dessous)
-    //{{0.0f, 0.0f, -2.5f}, 1.0f},    // Sphère derrière
-    //{{0.0f, 0.0f, 2.5f}, 1.0f},     // Sphère devant
-    //{{-1.5f, 0.0f, -1.5f}, 0.5f},   // Petite sphère
-};
-
-// Matériaux correspondants
-//int type;       // Type de matériau
-//float roughness; // Rugosité (métal, verre)
-//float ior;      // Indice de réfraction (verre)
-//float padding;  // Padding pour l'alignement
-//vec3 albedo;    // Couleur de base
-//float padding2; // Padding supplémentaire
-
-Material2 materials[MAX_SPHERES] = {
-    {4, 0.0f, 1.0f, 0.0f, {1.0f, 1.0f, 1.0f}, 0.0f},    // Balle miroir
-    {3, 0.0f, 1.0f, 0.0f, {0.9f, 0.9f, 0.0f}, 0.0f}     // Jaune diffus
-    //{1, 0.1f, 1.0f, 0.0f, {0.8f, 0.8f, 0.9f}, 0.0f},    // Métal bleuté
-    //{2, 0.0f, 1.5f, 0.0f, {0.9f, 0.9f, 0.9f}, 0.0f},    // Verre
-    //{0, 0.5f, 1.0f, 0.0f, {0.8f, 0.8f, 0.8f}, 0.0f},    // Sol gris diffus
-    //{0, 0.2f, 1.0f, 0.0f, {0.9f, 0.3f, 0.3f}, 0.0f},    // Rouge diffus
-    //{1, 0.2f, 1.0f, 0.0f, {0.9f, 0.6f, 0.2f}, 0.0f},    // Métal doré
-    //{2, 0.1f, 1.3f, 0.0f, {0.3f, 0.7f, 0.9f}, 0.0f},    // Verre bleuté
-};
-
-// Dans main.cpp, ajustez la définition des murs selon vos besoins
-Block blocks[MAX_BLOCKS] = {
-    {{0.0f, -1.0f, 0.0f}, {20.0f, 0.1f, 20.0f}},  // Sol
-    {{0.0f, 10.0f, 0.0f}, {20.0f, 0.1f, 20.0f}},  // Plafond
-    {{-10.0f, 0.0f, 0.0f}, {0.1f, 20.0f, 20.0f}}, // Mur gauche
-    {{10.0f, 0.0f, 0.0f}, {0.1f, 20.0f, 20.0f}},  // Mur droit
-    {{0.0f, 0.0f, -10.0f}, {20.0f, 20.0f, 0.1f}}, // Mur arrière
-    {{0.0f, 0.0f, 10.0f}, {20.0f, 20.0f, 0.1f}}   // Mur avant
-};
-
-Material2 materials_block[MAX_BLOCKS] = {
-    {1, 0.80f, 1.0f, 0.0f, {0.2f, 0.2f, 0.225f}, 0.0f}, // Mur gauche gris
-    {1, 0.80f, 1.0f, 0.0f, {0.2f, 0.2f, 0.225f}, 0.0f}, // Mur droit gris
-    {1, 0.80f, 1.0f, 0.0f, {0.2f, 0.2f, 0.225f}, 0.0f}, // Mur arrière gris
-    {1, 0.80f, 1.0f, 0.0f, {0.2f, 0.2f, 0.225f}, 0.0f}, // Mur avant gris
-    {1, 0.80f, 1.0f, 0.0f, {0.2f, 0.2f, 0.225f}, 0.0f}, // Mur gauche avant gris
-    {1, 0.80f, 1.0f, 0.0f, {0.2f, 0.2f, 0.225f}, 0.0f}  // Mur droit avant gris
-};
-
-
-// Position de la lumière
-Vector3 lightPos = {5.0f, 10.0f, -2.0f};
-// Couleur de la lumière
-Vector3 lightColor = {1.0f, 0.9f, 0.8f}; // Lumière légèrement chaude
-// Intensité de la lumière
-float lightIntensity = 5.0f;
-
-int main(void) {
+// Utilisation : ./main [scene.rtscene] [--mesh modele.obj] [--scale s] [--spp n] [--budget ms]
+// (scène intégrée de scene.cpp par défaut ; --mesh ajoute les triangles d'un modèle raylib ;
+// --scale : résolution interne maximale en fraction de la fenêtre, 1 par défaut ;
+// --spp : échantillons par pixel et par frame, 0.25 à 16, 1 par défaut ;
+// --budget : temps GPU visé par frame pour la résolution dynamique, 16.6 ms par défaut)
+static void printUsage(const char *program) {
+    printf("Utilisation : %s [scene.rtscene] [--mesh modele.obj] [--scale s] [--spp n] [--budget ms]\n", program);
+}
+
+int main(int argc, char **argv) {
+    const char *sceneFileName = NULL;
+    const char *meshFileName = NULL;
+    float renderScale = 1.0f;
+    float samplesPerPixel = 1.0f;
+    float frameBudgetMs = 16.6f;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--mesh") == 0 && i + 1 < argc) meshFileName = argv[++i];
+        else if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc) renderScale = Clamp((float)atof(argv[++i]), 0.1f, 2.0f);
+        else if (strcmp(argv[i], "--spp") == 0 && i + 1 < argc) samplesPerPixel = Clamp((float)atof(argv[++i]), 0.25f, 16.0f);
+        else if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc) frameBudgetMs = fmaxf((float)atof(argv[++i]), 1.0f);
+        else if (argv[i][0] != '-' && sceneFileName == NULL) sceneFileName = argv[i];
+        else {
+            // Option inconnue, valeur manquante ou deuxième scène
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
     // Initialisation
     const int screenWidth = 1280;
     const int screenHeight = 720;
     
-    SetConfigFlags(FLAG_MSAA_4X_HINT); // Enable Multi Sampling Anti Aliasing 4x (if available)
+    SetConfigFlags(FLAG_MSAA_4X_HINT | FLAG_WINDOW_RESIZABLE); // Enable Multi Sampling Anti Aliasing 4x (if available)
     InitWindow(screenWidth, screenHeight, "Raytracer avancé - GLSL");
     
     Camera camera = { 0 };
@@ -132,55 +92,211 @@ int main(void) {
     //test denoiser plusieurs passes
     Shader denoise_shader = LoadShader(0, "denoise.fs");
     Shader taa_shader = LoadShader(0, "taa.fs");
+    Shader reproject_shader = LoadShader(0, "reproject.fs");
+    Shader tonemap_shader = LoadShader(0, "tonemap.fs");
+    Shader accumulate_shader = LoadShader(0, "accumulate.fs");
+    Shader sample_budget_shader = LoadShader(0, "sample_budget.fs");
+    Shader sample_budget_reduce_shader = LoadShader(0, "sample_budget_reduce.fs");
     
     // Récupération des emplacements des uniformes dans le shader
     int viewEyeLoc = GetShaderLocation(shader, "viewEye");
     int viewCenterLoc = GetShaderLocation(shader, "viewCenter");
+    int prevViewEyeLoc = GetShaderLocation(shader, "prevViewEye");
+    int prevViewCenterLoc = GetShaderLocation(shader, "prevViewCenter");
     int resolutionLoc = GetShaderLocation(shader, "resolution");
     int timeLoc = GetShaderLocation(shader, "time");
+    int adaptiveThresholdLoc = GetShaderLocation(shader, "adaptiveThreshold");
+    int samplerTypeLoc = GetShaderLocation(shader, "samplerType");
+    int samplerSeedLoc = GetShaderLocation(shader, "samplerSeed");
+    int sampleOffsetLoc = GetShaderLocation(shader, "sampleOffset");
+    int samplesPerPixelLoc = GetShaderLocation(shader, "samplesPerPixel");
+    int frameIndexLoc = GetShaderLocation(shader, "frameIndex");
+    int cameraJitterLoc = GetShaderLocation(shader, "cameraJitter");
+    int pixelJitterLoc = GetShaderLocation(shader, "pixelJitter");
+    int sampleBudgetLoc = GetShaderLocation(shader, "sampleBudget");
+    int sampleBudgetStateLoc = GetShaderLocation(shader, "sampleBudgetState");
+    int useSampleBudgetLoc = GetShaderLocation(shader, "useSampleBudget");
     
-    // Paramètres de résolution pour le shader
-    float resolution[2] = { (float)screenWidth, (float)screenHeight };
+    // Résolution interne de la chaîne de rendu (fenêtre x échelle), suit la fenêtre ;
+    // l'échelle vaut renderScale ou le palier de la résolution dynamique
+    int renderWidth = (int)(screenWidth * renderScale);
+    int renderHeight = (int)(screenHeight * renderScale);
+    float resolution[2] = { (float)renderWidth, (float)renderHeight };
     SetShaderValue(shader, resolutionLoc, resolution, SHADER_UNIFORM_VEC2);
     
-    // Emplacement des uniformes pour les sphères et les matériaux
-    int spheresLoc = GetShaderLocation(shader, "spheres");
-    int materialsLoc = GetShaderLocation(shader, "materials");
-    int sphereCountLoc = GetShaderLocation(shader, "sphereCount");
-    int lightPosLoc = GetShaderLocation(shader, "lightPos");
-    int lightColorLoc = GetShaderLocation(shader, "lightColor");
-    int lightIntensityLoc = GetShaderLocation(shader, "lightIntensity");
-    //pareil pour les blocs de murs
-    int blocksLoc = GetShaderLocation(shader, "blocks");
-    int materialsBlockLoc = GetShaderLocation(shader, "materials_block");
-    int blockCountLoc = GetShaderLocation(shader, "blockCount");
-    
-    // Passage du nombre de sphères au shader
-    int sphereCount = MAX_SPHERES;
-    SetShaderValue(shader, sphereCountLoc, &sphereCount, SHADER_UNIFORM_INT);
-    
-    // Passage du nombre de blocs au shader
-    int blockCount = MAX_BLOCKS;
-    SetShaderValue(shader, blockCountLoc, &blockCount, SHADER_UNIFORM_INT);
+    // Emplacements des uniformes de la passe de TAA (débruitage : voir denoiser.h)
+    int taaResolutionLoc = GetShaderLocation(taa_shader, "resolution");    // résolution interne (currentFrame)
+    int taaOutputResolutionLoc = GetShaderLocation(taa_shader, "outputResolution");
+    int taaJitterLoc = GetShaderLocation(taa_shader, "jitter");
+    int taaTimeLoc = GetShaderLocation(taa_shader, "time");
+    int taaFrameLoc = GetShaderLocation(taa_shader, "frame");
+    int taaCurrentLoc = GetShaderLocation(taa_shader, "currentFrame");
+    int taaHistoryLoc = GetShaderLocation(taa_shader, "historyFrame");
+    SetShaderValue(taa_shader, taaResolutionLoc, resolution, SHADER_UNIFORM_VEC2);
+
+    // Reprojection de l'historique (vecteurs de mouvement du G-buffer)
+    int reprojectHistoryLoc = GetShaderLocation(reproject_shader, "historyFrame");
+    int reprojectMotionLoc = GetShaderLocation(reproject_shader, "motionVectors");
+    int reprojectNormalDepthLoc = GetShaderLocation(reproject_shader, "normalDepth");
+    int reprojectPrevNormalDepthLoc = GetShaderLocation(reproject_shader, "prevNormalDepth");
+    int reprojectSkipGeometryLoc = GetShaderLocation(reproject_shader, "skipGeometryTest");
+
+    // Copie de la scène en structure de tableaux : le CPU travaille dessus,
+    // la disposition GPU est reconstruite à l'envoi. Un fichier .rtscene est projeté
+    // en mémoire et utilisé tel quel (tableaux SoA et BVH précalculé).
+    SceneSoA sceneSoA;
+    SceneFile sceneFile;
+    bool sceneFromFile = sceneFileName != NULL;
+    if (sceneFromFile) {
+        if (!loadSceneFile(&sceneFile, sceneFileName)) {
+            CloseWindow();
+            return 1;
+        }
+        sceneSoA = sceneFile.soa;
+
+        // Caméra en orbite autour de la cible du fichier
+        const SceneInfo *info = &sceneFile.info;
+        Vector3 offset = Vector3Subtract(info->cameraEye, info->cameraTarget);
+        distance_cam = Vector3Length(offset);
+        if (distance_cam > 0.0f) {
+            angleX = RAD2DEG * asinf(offset.y / distance_cam);
+            angleY = RAD2DEG * atan2f(offset.x, offset.z);
+        }
+        camera.target = info->cameraTarget;
+        camera.fovy = info->cameraFovy;
+        lightPos = info->lightPos;
+        lightColor = info->lightColor;
+        lightIntensity = info->lightIntensity;
+    }
+    else if (!loadSceneSoAFromArrays(&sceneSoA, spheres, materials, MAX_SPHERES, blocks, materials_block, MAX_BLOCKS)) {
+        TraceLog(LOG_ERROR, "Allocation de la scene impossible");
+        CloseWindow();
+        return 1;
+    }
+
+    // Maillage ajouté en triangles (diffus gris clair) : le BVH du fichier ne le couvre pas
+    bool meshAdded = false;
+    if (meshFileName != NULL) {
+        Material2 meshMaterial = { MAT_DIFFUSE, 0.5f, 1.0f, 0.0f, { 0.8f, 0.8f, 0.8f }, 0.0f };
+        int meshTriangles = appendModelTriangles(&sceneSoA, meshFileName, meshMaterial);
+        if (meshTriangles < 0) {
+            unloadSceneSoA(&sceneSoA);
+            if (sceneFromFile) unloadSceneFile(&sceneFile);
+            CloseWindow();
+            return 1;
+        }
+        meshAdded = meshTriangles > 0;
+    }
+
+    // Envoi de la scène dans une texture de données : seules les plages modifiées
+    // sont renvoyées (tout est marqué pour la première frame)
+    SceneUploader sceneUploader;
+    if (!loadSceneUploader(&sceneUploader, shader, &sceneSoA)) {
+        unloadSceneSoA(&sceneSoA);
+        if (sceneFromFile) unloadSceneFile(&sceneFile);
+        CloseWindow();
+        return 1;
+    }
+
+    // Construction du BVH (SAH), sauf s'il est précalculé dans le fichier de scène (lu
+    // directement dans la projection), et aplatissement dans une texture flottante pour le shader
+    Bvh bvh;
+    BvhView bvhView;
+    if (sceneFromFile && !meshAdded && sceneFile.bvh.nodeCount > 0) bvhView = sceneFile.bvh;
+    else {
+        buildBvh(&bvh, &sceneSoA);
+        bvhView = makeBvhView(&bvh);
+    }
+    std::vector<float> bvhTexels;
+    int bvhTexWidth, bvhTexHeight, bvhPrimOffset;
+    flattenBvhTexture(&bvhView, &bvhTexels, &bvhTexWidth, &bvhTexHeight, &bvhPrimOffset);
+
+    Texture2D bvhTexture = { 0 };
+    bvhTexture.id = rlLoadTexture(bvhTexels.data(), bvhTexWidth, bvhTexHeight, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, 1);
+    bvhTexture.width = bvhTexWidth;
+    bvhTexture.height = bvhTexHeight;
+    bvhTexture.mipmaps = 1;
+    bvhTexture.format = PIXELFORMAT_UNCOMPRESSED_R32G32B32A32;
+    SetTextureFilter(bvhTexture, TEXTURE_FILTER_POINT);
+
+    int bvhTextureLoc = GetShaderLocation(shader, "bvhTexture");
+    int bvhNodeCount = bvhView.nodeCount;
+    SetShaderValue(shader, GetShaderLocation(shader, "bvhNodeCount"), &bvhNodeCount, SHADER_UNIFORM_INT);
+    SetShaderValue(shader, GetShaderLocation(shader, "bvhPrimOffset"), &bvhPrimOffset, SHADER_UNIFORM_INT);
 
     float runTime = 0.0f;
     
     DisableCursor();  // Limite le curseur à l'intérieur de la fenêtre
 
-    //la render texture pour appliquer le post process shader
-    RenderTexture2D target = LoadRenderTexture(screenWidth, screenHeight);
-    //RenderTexture2D history = LoadRenderTexture(screenWidth, screenHeight);
+    // Cibles de rendu à la résolution interne, réallouées quand elle change ; M : mémoire par cible
+    RenderPool renderPool;
+    initRenderPool(&renderPool, renderWidth, renderHeight);
+    bool showRenderPool = false;
+    // Cibles à la résolution de la fenêtre : historique du TAA, qui agrandit la frame
+    // interne et survit ainsi aux changements de palier de la résolution dynamique
+    RenderPool outputPool;
+    initRenderPool(&outputPool, screenWidth, screenHeight);
 
     //pour le shader de denoising
-    RenderTexture2D renderNoisy = LoadRenderTexture(screenWidth, screenHeight);
-    RenderTexture2D renderNormals = LoadRenderTexture(screenWidth, screenHeight);
-    RenderTexture2D renderHistory = LoadRenderTexture(screenWidth, screenHeight);
-    RenderTexture2D denoiseTarget = LoadRenderTexture(screenWidth, screenHeight);
-    RenderTexture2D taaOutput = LoadRenderTexture(screenWidth, screenHeight);
+    // G-buffer rempli par la passe de raytracing : couleur bruitée, normale + profondeur, albedo + matériau
+    GBuffer gbuffer;
+    if (!loadGBuffer(&gbuffer, renderWidth, renderHeight)) {
+        CloseWindow();
+        return 1;
+    }
+    addExternalRenderTarget(&renderPool, "gbuffer", GBUFFER_BYTES_PER_PIXEL);
+    // Historique du TAA en double tampon : la passe de TAA écrit directement dans l'un en
+    // lisant l'autre (reprojeté), puis les rôles s'échangent ; pas de copie.
+    // Filtrage bilinéaire : lu entre les texels après reprojection et agrandi à l'affichage
+    int renderHistory[2];
+    renderHistory[0] = addRenderTarget(&outputPool, "history_a", RENDER_TARGET_RGBA16F, TEXTURE_FILTER_BILINEAR);
+    renderHistory[1] = addRenderTarget(&outputPool, "history_b", RENDER_TARGET_RGBA16F, TEXTURE_FILTER_BILINEAR);
+    int historyIndex = 0;   // historique de la frame précédente ; l'autre reçoit le TAA courant
+    int reprojectedHistory = addRenderTarget(&outputPool, "history_reproj", RENDER_TARGET_RGBA16F, TEXTURE_FILTER_POINT);
     
     int frameCounter = 0;
-
-    SetTargetFPS(600); // Limite les FPS à 60
+    // Caméra de la frame précédente, pour les vecteurs de mouvement de raytest.fs
+    Vector3 prevCameraPos = camera.position;
+    Vector3 prevCameraTarget = camera.target;
+
+    // Temps GPU par passe (requêtes GL_TIME_ELAPSED), G : affichage, L : log CSV
+    GpuTimer gpuTimer;
+    initGpuTimer(&gpuTimer);
+    int raytracePass = addGpuPass(&gpuTimer, "raytrace");
+    int taaPass = addGpuPass(&gpuTimer, "taa");
+    int reprojectPass = addGpuPass(&gpuTimer, "reproject");
+    int presentPass = addGpuPass(&gpuTimer, "present");
+    bool showGpuTimings = false;
+
+    // Débruitage à-trous, [ et ] : nombre d'itérations (passes atrous_1 à atrous_16)
+    Denoiser denoiser;
+    // Accumulation progressive (P) : moyenne de toutes les frames depuis le dernier changement
+    // de caméra, de lumière, de matériau ou de tirage. La lumière est fixe au départ (sinon la
+    // moyenne repartirait de zéro à chaque frame) ; Espace lance ou arrête son animation
+    Accumulator accumulator;
+    bool progressive = true;
+    bool animateLight = false;
+    // Jitter de caméra Halton (2, 3) retiré par le TAA (T) ; sinon jitter par échantillon dans le pixel
+    bool temporalJitter = true;
+    float lightTime = 0.0f;
+    // Mode adaptatif (V) : budget d'échantillons réparti selon la variance de la frame précédente
+    SampleBudget sampleBudget;
+
+    if (!loadDenoiser(&denoiser, denoise_shader, &renderPool, 3, &gpuTimer)
+        || !loadAccumulator(&accumulator, accumulate_shader, &renderPool, &gpuTimer)
+        || !loadSampleBudget(&sampleBudget, sample_budget_shader, sample_budget_reduce_shader, &renderPool, &gpuTimer)
+        || renderHistory[0] < 0 || renderHistory[1] < 0 || reprojectedHistory < 0) {
+        CloseWindow();
+        return 1;
+    }
+    logRenderPool(&renderPool);
+    logRenderPool(&outputPool);
+
+    // Résolution dynamique (D) : paliers de 5 % entre la moitié de renderScale et renderScale,
+    // pilotés par le temps GPU de toutes les passes (temps de frame CPU sans GL_TIME_ELAPSED).
+    // Pas de limite de FPS : quand le traceur est le goulot, c'est la résolution qui cède.
+    ResolutionController resolutionController;
+    initResolutionController(&resolutionController, frameBudgetMs, 0.5f * renderScale, renderScale, 0.05f * renderScale);
     
     // Boucle principale du jeu
     while (!WindowShouldClose()) {
@@ -212,14 +328,18 @@ int main(void) {
         float radAngleX = DEG2RAD * angleX;
         float radAngleY = DEG2RAD * angleY;
         
-        camera.position.x = distance_cam * cos(radAngleX) * sin(radAngleY);
-        camera.position.y = distance_cam * sin(radAngleX);
-        camera.position.z = distance_cam * cos(radAngleX) * cos(radAngleY);
+        camera.position.x = camera.target.x + distance_cam * cos(radAngleX) * sin(radAngleY);
+        camera.position.y = camera.target.y + distance_cam * sin(radAngleX);
+        camera.position.z = camera.target.z + distance_cam * cos(radAngleX) * cos(radAngleY);
         
-        // Mouvement de la lumière sur un chemin circulaire
-        lightPos.x = 5.0f * cosf(runTime * 0.5f);
-        lightPos.y = 5.0f + 2.0f * sinf(runTime * 0.3f);
-        lightPos.z = 3.0f * sinf(runTime * 0.7f);
+        // Mouvement de la lumière sur un chemin circulaire (Espace ; arrêtée, l'image converge)
+        if (IsKeyPressed(KEY_SPACE)) animateLight = !animateLight;
+        if (animateLight) {
+            lightTime += deltaTime;
+            lightPos.x = 5.0f * cosf(lightTime * 0.5f);
+            lightPos.y = 5.0f + 2.0f * sinf(lightTime * 0.3f);
+            lightPos.z = 3.0f * sinf(lightTime * 0.7f);
+        }
         
         // Contrôles optionnels pour ajuster manuellement la lumière
         if (IsKeyDown(KEY_U)) lightPos.y += 0.2f;
@@ -228,6 +348,36 @@ int main(void) {
         if (IsKeyDown(KEY_K)) lightPos.x += 0.2f;
         if (IsKeyDown(KEY_Y)) lightIntensity -= 0.2f;
         if (IsKeyDown(KEY_I)) lightIntensity += 0.2f;
+        // Échantillonnage adaptatif dans raytest.fs (arrêt des pixels convergés)
+        static bool isAdaptive = false;
+        if (IsKeyPressed(KEY_V)) isAdaptive = !isAdaptive;
+        float adaptiveThreshold = isAdaptive ? 0.02f : 0.0f;
+
+        // Suite des tirages de raytest.fs : Sobol-Owen, rang 1, bruit blanc
+        static int samplerType = SAMPLER_SOBOL;
+        if (IsKeyPressed(KEY_N)) samplerType = (samplerType + 1) % SAMPLER_COUNT;
+
+        // Budget d'échantillons par frame (, et .) : en dessous de 1, une partie des pixels
+        // seulement est tracée à chaque frame, le débruiteur et le TAA complètent
+        if (IsKeyPressed(KEY_COMMA)) samplesPerPixel = fmaxf(samplesPerPixel * 0.5f, 0.25f);
+        if (IsKeyPressed(KEY_PERIOD)) samplesPerPixel = fminf(samplesPerPixel * 2.0f, 16.0f);
+
+        if (IsKeyPressed(KEY_LEFT_BRACKET)) setDenoiserIterations(&denoiser, denoiser.iterations - 1);
+        if (IsKeyPressed(KEY_RIGHT_BRACKET)) setDenoiserIterations(&denoiser, denoiser.iterations + 1);
+
+        if (IsKeyPressed(KEY_G)) showGpuTimings = !showGpuTimings;
+        if (IsKeyPressed(KEY_M)) showRenderPool = !showRenderPool;
+        if (IsKeyPressed(KEY_D)) resolutionController.enabled = !resolutionController.enabled;
+        if (IsKeyPressed(KEY_T)) temporalJitter = !temporalJitter;
+        if (IsKeyPressed(KEY_P)) {
+            progressive = !progressive;
+            resetAccumulator(&accumulator);
+        }
+        if (IsKeyPressed(KEY_L)) {
+            if (gpuTimer.log != NULL) stopGpuTimerLog(&gpuTimer);
+            else startGpuTimerLog(&gpuTimer, "gpu_timings.csv");
+        }
+
         // Variable pour suivre si la touche R est pressée
         static bool isColorCycling = false;
 
@@ -237,21 +387,22 @@ int main(void) {
         }
 
         // Si le cycle de couleurs est actif, modifier les couleurs
-        if (isColorCycling) {
+        if (isColorCycling && sceneSoA.sphereCount > 1) {
             // Cycle de couleurs pour la première sphère (miroir)
             //materials[0].albedo.x = 0.5f + 0.5f * sinf(runTime * 1.1f);          // Rouge
             //materials[0].albedo.y = 0.5f + 0.5f * sinf(runTime * 0.7f + 2.0f);   // Vert
             //materials[0].albedo.z = 0.5f + 0.5f * sinf(runTime * 0.9f + 4.0f);   // Bleu
             
             // Cycle de couleurs pour la sphère émissive (index 7)
-            materials[1].albedo.x = 0.5f + 0.5f * sinf(runTime * 0.5f + 1.0f);   // Rouge
-            materials[1].albedo.y = 0.5f + 0.5f * sinf(runTime * 0.8f + 3.0f);   // Vert
-            materials[1].albedo.z = 0.5f + 0.5f * sinf(runTime * 0.6f + 5.0f);   // Bleu
+            sceneSoA.sphereMaterials.albedoR[1] = 0.5f + 0.5f * sinf(runTime * 0.5f + 1.0f);   // Rouge
+            sceneSoA.sphereMaterials.albedoG[1] = 0.5f + 0.5f * sinf(runTime * 0.8f + 3.0f);   // Vert
+            sceneSoA.sphereMaterials.albedoB[1] = 0.5f + 0.5f * sinf(runTime * 0.6f + 5.0f);   // Bleu
             
             // Synchroniser la couleur de la lumière avec la sphère émissive
-            lightColor.x = materials[1].albedo.x;
-            lightColor.y = materials[1].albedo.y;
-            lightColor.z = materials[1].albedo.z;
+            lightColor.x = sceneSoA.sphereMaterials.albedoR[1];
+            lightColor.y = sceneSoA.sphereMaterials.albedoG[1];
+            lightColor.z = sceneSoA.sphereMaterials.albedoB[1];
+            markSpheresDirty(&sceneUploader, 1, 1);
         }
         // Make light intensity oscillate between 0 and 2
         //lightIntensity = 1.0f + sinf(runTime * 1.5f);
@@ -261,95 +412,91 @@ int main(void) {
         
         // Passage des valeurs des uniformes au shader
         float cameraPos[3] = { camera.position.x, camera.position.y, camera.position.z };
-        float cameraTarget[3] = { 0.0f, 0.0f, 0.0f }; // On regarde toujours l'origine
+        float cameraTarget[3] = { camera.target.x, camera.target.y, camera.target.z }; // Centre de l'orbite
         
         SetShaderValue(shader, viewEyeLoc, cameraPos, SHADER_UNIFORM_VEC3);
         SetShaderValue(shader, viewCenterLoc, cameraTarget, SHADER_UNIFORM_VEC3);
+        if (frameCounter == 0) {
+            prevCameraPos = camera.position;
+            prevCameraTarget = camera.target;
+        }
+        SetShaderValue(shader, prevViewEyeLoc, &prevCameraPos, SHADER_UNIFORM_VEC3);
+        SetShaderValue(shader, prevViewCenterLoc, &prevCameraTarget, SHADER_UNIFORM_VEC3);
+        prevCameraPos = camera.position;
+        prevCameraTarget = camera.target;
         SetShaderValue(shader, timeLoc, &runTime, SHADER_UNIFORM_FLOAT);
+        SetShaderValue(shader, adaptiveThresholdLoc, &adaptiveThreshold, SHADER_UNIFORM_FLOAT);
+        SetShaderValue(shader, samplerTypeLoc, &samplerType, SHADER_UNIFORM_INT);
         
-        // Envoi des données des sphères et des matériaux au shader
-        // Note: Ces structures doivent être correctement alignées pour le GPU
-        for (int i = 0; i < MAX_SPHERES; i++) {
-            // Format vec4 pour chaque sphère (position + rayon)
-            float sphereData[4] = { 
-                spheres[i].position.x, 
-                spheres[i].position.y, 
-                spheres[i].position.z, 
-                spheres[i].radius 
-            };
-            SetShaderValue(shader, GetShaderLocation(shader, TextFormat("spheres[%d]", i)), 
-                           sphereData, SHADER_UNIFORM_VEC4);
-                           
-            // Transmission du matériau
-            // Attention: ceci est une approche simplifiée, l'alignement peut poser problème
-            // Pour un code plus robuste, considérer l'utilisation d'UBO/SSBO si disponible
-            SetShaderValue(shader, GetShaderLocation(shader, TextFormat("materials[%d].type", i)), 
-                          &materials[i].type, SHADER_UNIFORM_INT);
-            SetShaderValue(shader, GetShaderLocation(shader, TextFormat("materials[%d].roughness", i)), 
-                          &materials[i].roughness, SHADER_UNIFORM_FLOAT);
-            SetShaderValue(shader, GetShaderLocation(shader, TextFormat("materials[%d].ior", i)), 
-                          &materials[i].ior, SHADER_UNIFORM_FLOAT);
-            SetShaderValue(shader, GetShaderLocation(shader, TextFormat("materials[%d].albedo", i)), 
-                          &materials[i].albedo, SHADER_UNIFORM_VEC3);
-        }
-        // Envoi des données des blocs et de leurs matériaux au shader
-        for (int i = 0; i < MAX_BLOCKS; i++) {
-            // Format vec4 pour chaque bloc (position + taille)
-            float blockPos[3] = {
-        blocks[i].position.x, 
-        blocks[i].position.y, 
-        blocks[i].position.z
-    };
-    SetShaderValue(shader, GetShaderLocation(shader, TextFormat("blocks[%d]", i)),
-                   blockPos, SHADER_UNIFORM_VEC3);
-    
-    // Transmettez la taille séparément
-    float blockSize[3] = {
-        blocks[i].size.x,
-        blocks[i].size.y,
-        blocks[i].size.z
-    };
-    SetShaderValue(shader, GetShaderLocation(shader, TextFormat("blockSizes[%d]", i)),
-                   blockSize, SHADER_UNIFORM_VEC3);
-            // Transmission du matériau du bloc
-            SetShaderValue(shader, GetShaderLocation(shader, TextFormat("materials_block[%d].type", i)),
-                          &materials_block[i].type, SHADER_UNIFORM_INT);
-            SetShaderValue(shader, GetShaderLocation(shader, TextFormat("materials_block[%d].roughness", i)),
-                            &materials_block[i].roughness, SHADER_UNIFORM_FLOAT);
-            SetShaderValue(shader, GetShaderLocation(shader, TextFormat("materials_block[%d].ior", i)),
-                            &materials_block[i].ior, SHADER_UNIFORM_FLOAT);
-            SetShaderValue(shader, GetShaderLocation(shader, TextFormat("materials_block[%d].albedo", i)),
-                            &materials_block[i].albedo, SHADER_UNIFORM_VEC3);
+        // Envoi des parties de la scène modifiées depuis la frame précédente
+        setSceneLight(&sceneUploader, lightPos, lightColor, lightIntensity);
+        uploadScene(&sceneUploader, &sceneSoA);
+
+        // Palier de la résolution dynamique, d'après la dernière frame mesurée. Figé pendant
+        // l'accumulation progressive : l'image immobile converge au lieu de repartir de zéro
+        bool accumulating = progressive && accumulator.frameCount > 1;
+        if (!accumulating) {
+            float frameMs = gpuTimer.supported ? gpuTimer.lastFrameMs : deltaTime * 1000.0f;
+            updateResolutionController(&resolutionController, frameMs);
         }
-        
-        // Mise à jour de la position de la lumière
-        SetShaderValue(shader, lightPosLoc, &lightPos, SHADER_UNIFORM_VEC3);
-        SetShaderValue(shader, lightColorLoc, &lightColor, SHADER_UNIFORM_VEC3);
-        SetShaderValue(shader, lightIntensityLoc, &lightIntensity, SHADER_UNIFORM_FLOAT);
-        
-        //liaison entre les textures et les shaders
-        SetShaderValueTexture(denoise_shader, GetShaderLocation(denoise_shader, "renderNoisy"), renderNoisy.texture);
-        SetShaderValueTexture(denoise_shader, GetShaderLocation(denoise_shader, "renderNormals"), renderNormals.texture);
-        SetShaderValueTexture(denoise_shader, GetShaderLocation(denoise_shader, "renderHistory"), renderHistory.texture);
-
-        //pour le taa shader
-        SetShaderValue(taa_shader, GetShaderLocation(taa_shader, "resolution"), resolution, SHADER_UNIFORM_VEC2);
-        SetShaderValue(taa_shader, GetShaderLocation(taa_shader, "time"), &runTime, SHADER_UNIFORM_FLOAT);
-        SetShaderValue(taa_shader, GetShaderLocation(taa_shader, "frame"), &frameCounter, SHADER_UNIFORM_INT);
 
-        SetShaderValueTexture(taa_shader, GetShaderLocation(taa_shader, "currentFrame"), denoiseTarget.texture);
-        SetShaderValueTexture(taa_shader, GetShaderLocation(taa_shader, "historyFrame"), renderHistory.texture);
-
-
-        // Vérification si la fenêtre est redimensionnée
-        if (IsWindowResized()) {
-            resolution[0] = (float)GetScreenWidth();
-            resolution[1] = (float)GetScreenHeight();
+        // Fenêtre redimensionnée : l'historique du TAA suit la fenêtre (effacé, le TAA repart de
+        // la frame courante) ; les cibles internes suivent la fenêtre et le palier
+        if (resizeRenderPool(&outputPool, GetScreenWidth(), GetScreenHeight()) < 0) break;
+        float scale = resolutionControllerScale(&resolutionController);
+        renderWidth = (int)(GetScreenWidth() * scale);
+        renderHeight = (int)(GetScreenHeight() * scale);
+        int poolResize = resizeRenderPool(&renderPool, renderWidth, renderHeight);
+        if (poolResize < 0) break;
+        bool resized = poolResize > 0;
+        renderWidth = renderPool.width;     // bornée à 1 (fenêtre réduite)
+        renderHeight = renderPool.height;
+        if (resized) {
+            unloadGBuffer(&gbuffer);
+            if (!loadGBuffer(&gbuffer, renderWidth, renderHeight)) break;
+            resolution[0] = (float)renderWidth;
+            resolution[1] = (float)renderHeight;
             SetShaderValue(shader, resolutionLoc, resolution, SHADER_UNIFORM_VEC2);
+            SetShaderValue(taa_shader, taaResolutionLoc, resolution, SHADER_UNIFORM_VEC2);
         }
+        // Normales et profondeurs précédentes perdues avec le G-buffer réalloué : la reprojection
+        // ne garde que le test d'écran pour cette frame
+        int skipGeometryTest = resized ? 1 : 0;
+
+        // Détection des changements : la moyenne repart de zéro. Pendant une accumulation,
+        // la graine reste fixe et les indices continuent la suite (écart = plafond
+        // d'échantillons par pixel de raytest.fs, MAX_SAMPLES ou ADAPTIVE_MAX_SAMPLES)
+        AccumulationKey accumulationKey = { camera.position, camera.target, samplerType, adaptiveThreshold,
+                                            samplesPerPixel, renderWidth, renderHeight };
+        updateAccumulator(&accumulator, &accumulationKey, sceneUploader.uploadCount > 0);
+        int samplerSeed = progressive ? accumulator.seed : frameCounter;
+        int sampleStride = isAdaptive ? 16 : (int)ceilf(samplesPerPixel);
+        int sampleOffset = progressive ? accumulator.frameCount * sampleStride : 0;
+        SetShaderValue(shader, samplerSeedLoc, &samplerSeed, SHADER_UNIFORM_INT);
+        SetShaderValue(shader, sampleOffsetLoc, &sampleOffset, SHADER_UNIFORM_INT);
+        SetShaderValue(shader, samplesPerPixelLoc, &samplesPerPixel, SHADER_UNIFORM_FLOAT);
+        SetShaderValue(shader, frameIndexLoc, &frameCounter, SHADER_UNIFORM_INT);
+        // Frames de la chaîne TAA : un point par pixel, déplacé à chaque frame. Frames accumulées
+        // (la première exceptée, affichée par le TAA) : échantillons répartis dans le pixel, la
+        // moyenne ne sait pas retirer un décalage de caméra
+        bool jitterFrame = temporalJitter && !(progressive && accumulator.frameCount > 0);
+        Vector2 cameraJitter = jitterFrame ? haltonJitter(frameCounter) : (Vector2){ 0.0f, 0.0f };
+        int pixelJitter = jitterFrame ? 0 : 1;
+        SetShaderValue(shader, cameraJitterLoc, &cameraJitter, SHADER_UNIFORM_VEC2);
+        SetShaderValue(shader, pixelJitterLoc, &pixelJitter, SHADER_UNIFORM_INT);
         
         // Dessin
-        BeginTextureMode(renderNoisy);       // Enable drawing to texture
+        // Budget adaptatif d'après la couleur encore présente dans le G-buffer (frame précédente,
+        // indéfinie après une réallocation)
+        int useSampleBudget = (isAdaptive && !resized) ? 1 : 0;
+        if (useSampleBudget && !updateSampleBudget(&sampleBudget, &renderPool, gbuffer.target.texture, samplesPerPixel, &gpuTimer)) {
+            useSampleBudget = 0;
+        }
+        SetShaderValue(shader, useSampleBudgetLoc, &useSampleBudget, SHADER_UNIFORM_INT);
+        swapGBufferHistory(&gbuffer);   // normales et profondeurs de la frame précédente gardées pour la reprojection
+        beginGpuPass(&gpuTimer, raytracePass);
+        BeginTextureMode(gbuffer.target);    // Enable drawing to texture (G-buffer, 4 attachements)
+        beginGBufferWrite();
                           // End drawing to texture (now we have a texture available for next passes)
         
         //BeginDrawing();
@@ -359,121 +506,173 @@ int main(void) {
             // On dessine simplement un rectangle plein écran blanc,
             // l'image est générée dans le shader de raytracing
             BeginShaderMode(shader);
-                DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), WHITE);
+                // Les textures doivent être liées après BeginShaderMode (réinitialisées à chaque batch)
+                SetShaderValueTexture(shader, bvhTextureLoc, bvhTexture);
+                bindSceneTexture(&sceneUploader);
+                if (useSampleBudget) {
+                    SetShaderValueTexture(shader, sampleBudgetLoc, sampleBudgetDeviation(&sampleBudget, &renderPool));
+                    SetShaderValueTexture(shader, sampleBudgetStateLoc, sampleBudgetState(&sampleBudget));
+                }
+                DrawRectangle(0, 0, renderWidth, renderHeight, WHITE);
             EndShaderMode();
             //EndDrawing();
             
         //EndDrawing();
         
+        endGBufferWrite();
         EndTextureMode();
+        endGpuPass(&gpuTimer);
+
+
+            // Accumulation : dès la deuxième frame immobile, la moyenne (débruitée d'autant moins
+            // qu'elle compte de frames) remplace la chaîne temps réel reprojection + TAA
+            Texture2D displayed;
+            Texture2D accumulated = { 0 };
+            if (progressive) accumulated = accumulateFrame(&accumulator, &renderPool, gbuffer.target.texture, &gpuTimer);
+            if (progressive && accumulator.frameCount > 1) {
+                denoiser.varianceScale = 1.0f / (float)accumulator.frameCount;
+                displayed = runDenoiser(&denoiser, &renderPool, &gbuffer, accumulated, accumulated, 0.0f, &gpuTimer);
+            } else {
+                // Historique ramené sur les pixels courants ; alpha 1 là où la surface était cachée
+                // ou hors champ à la frame précédente
+                RenderTexture2D previousHistory = getRenderTarget(&outputPool, renderHistory[historyIndex]);
+                RenderTexture2D taaOutput = getRenderTarget(&outputPool, renderHistory[1 - historyIndex]);
+                RenderTexture2D reprojected = getRenderTarget(&outputPool, reprojectedHistory);
+                float outputWidth = (float)outputPool.width;
+                float outputHeight = (float)outputPool.height;
+
+                beginGpuPass(&gpuTimer, reprojectPass);
+                BeginTextureMode(reprojected);
+                    rlDisableColorBlend();  // alpha = taux de mélange du TAA, pas une opacité
+                    BeginShaderMode(reproject_shader);
+                        SetShaderValueTexture(reproject_shader, reprojectHistoryLoc, previousHistory.texture);
+                        SetShaderValueTexture(reproject_shader, reprojectMotionLoc, gbuffer.motion);
+                        SetShaderValueTexture(reproject_shader, reprojectNormalDepthLoc, gbuffer.normalDepth);
+                        SetShaderValueTexture(reproject_shader, reprojectPrevNormalDepthLoc, gbuffer.prevNormalDepth);
+                        SetShaderValue(reproject_shader, reprojectSkipGeometryLoc, &skipGeometryTest, SHADER_UNIFORM_INT);
+                        DrawTexturePro(
+                            previousHistory.texture,
+                            (Rectangle){ 0, 0, outputWidth, -outputHeight },
+                            (Rectangle){ 0, 0, outputWidth, outputHeight },
+                            (Vector2){ 0, 0 },
+                            0.0f,
+                            WHITE
+                        );
+                    EndShaderMode();
+                    rlEnableColorBlend();
+                EndTextureMode();
+                endGpuPass(&gpuTimer);
+
+                // Frame courante débruitée (valide jusqu'au prochain runDenoiser)
+                denoiser.varianceScale = 1.0f;
+                Texture2D denoised = runDenoiser(&denoiser, &renderPool, &gbuffer, gbuffer.target.texture, reprojected.texture,
+                                                 0.1f, &gpuTimer);
+
+                // Application du TAA à la texture de sortie finale, reconstruite de la résolution interne
+                // à celle de la fenêtre (TAAU, voir taa.fs)
+                beginGpuPass(&gpuTimer, taaPass);
+                BeginTextureMode(taaOutput);  // Capture le résultat du TAA dans taaOutput (historique de la frame suivante)
+                    rlDisableColorBlend();  // alpha = taux de mélange : sinon mélangé une seconde fois, sans reprojection
+                    BeginShaderMode(taa_shader);
+                        // Passer la texture courante (débruitée) et la frame précédente
+                        SetShaderValueTexture(taa_shader, taaCurrentLoc, denoised);
+                        SetShaderValueTexture(taa_shader, taaHistoryLoc, reprojected.texture);
+
+                        // Uniformes nécessaires
+                        SetShaderValue(taa_shader, taaTimeLoc, &runTime, SHADER_UNIFORM_FLOAT);
+                        SetShaderValue(taa_shader, taaFrameLoc, &frameCounter, SHADER_UNIFORM_INT);
+                        // Suréchantillonnage temporel : la frame interne est reconstruite à la taille de la fenêtre
+                        float outputResolution[2] = { outputWidth, outputHeight };
+                        SetShaderValue(taa_shader, taaOutputResolutionLoc, outputResolution, SHADER_UNIFORM_VEC2);
+                        SetShaderValue(taa_shader, taaJitterLoc, &cameraJitter, SHADER_UNIFORM_VEC2);
+
+                        DrawTexturePro(
+                            denoised,
+                            (Rectangle){ 0, 0, (float)renderWidth, -(float)renderHeight },
+                            (Rectangle){ 0, 0, outputWidth, outputHeight },
+                            (Vector2){ 0, 0 },
+                            0.0f,
+                            WHITE
+                        );
+                    EndShaderMode();
+                    rlEnableColorBlend();
+                EndTextureMode();
+                endGpuPass(&gpuTimer);
+                displayed = taaOutput.texture;
+                historyIndex = 1 - historyIndex;
+            }
 
+beginGpuPass(&gpuTimer, presentPass);
+BeginDrawing();
+    //ClearBackground(BLACK); //faut pas mettre ça sinon ça assombrit l'image
 
-            BeginTextureMode(denoiseTarget); // ← on dessine dans denoiseTarget (frame courante débruitée)
-                BeginShaderMode(denoise_shader);
-                    // Uniformes
-                    float resolution[2] = { (float)GetScreenWidth(), (float)GetScreenHeight() };
-                    SetShaderValue(denoise_shader, GetShaderLocation(denoise_shader, "resolution"), resolution, SHADER_UNIFORM_VEC2);
-
-                    SetShaderValue(denoise_shader, GetShaderLocation(denoise_shader, "time"), &runTime, SHADER_UNIFORM_FLOAT);
-                    SetShaderValue(denoise_shader, GetShaderLocation(denoise_shader, "frame"), &frameCounter, SHADER_UNIFORM_INT);
-
-                    float denoiseStrength = 1.0f;
-                    SetShaderValue(denoise_shader, GetShaderLocation(denoise_shader, "u_denoiseStrength"), &denoiseStrength, SHADER_UNIFORM_FLOAT);
-
-                    // Textures (attention aux noms !)
-                    SetShaderValueTexture(denoise_shader, GetShaderLocation(denoise_shader, "renderNoisy"), renderNoisy.texture);
-                    SetShaderValueTexture(denoise_shader, GetShaderLocation(denoise_shader, "renderNormals"), renderNormals.texture);
-                    SetShaderValueTexture(denoise_shader, GetShaderLocation(denoise_shader, "renderHistory"), renderHistory.texture);
-
-                    // Dessiner un quad plein écran pour appliquer le shader
-                    DrawTexturePro(
-                        renderNoisy.texture,                       // source texture (image bruitée)
-                        (Rectangle){ 0, 0, (float)screenWidth, -(float)screenHeight },
-                        (Rectangle){ 0, 0, (float)screenWidth, (float)screenHeight },
-                        (Vector2){ 0, 0 },
-                        0.0f,
-                        WHITE
-                    );
-                EndShaderMode();
-            EndTextureMode();
-
-// Application du TAA à la texture de sortie finale
-BeginTextureMode(taaOutput);  // Capture le résultat du TAA dans taaOutput
-    BeginShaderMode(taa_shader);
-        // Passer la texture courante (débruitée) et la frame précédente
-        SetShaderValueTexture(taa_shader, GetShaderLocation(taa_shader, "currentFrame"), denoiseTarget.texture);
-        SetShaderValueTexture(taa_shader, GetShaderLocation(taa_shader, "historyFrame"), renderHistory.texture);
-
-        // Uniformes nécessaires
-        SetShaderValue(taa_shader, GetShaderLocation(taa_shader, "time"), &runTime, SHADER_UNIFORM_FLOAT);
-        SetShaderValue(taa_shader, GetShaderLocation(taa_shader, "frame"), &frameCounter, SHADER_UNIFORM_INT);
-
+    // Dessiner le résultat du TAA ou de l'accumulation, tone mappé (sans mélange : l'alpha du TAA est son taux de mélange)
+    rlDisableColorBlend();
+    BeginShaderMode(tonemap_shader);
         DrawTexturePro(
-            denoiseTarget.texture,
-            (Rectangle){ 0, 0, (float)screenWidth, -(float)screenHeight },
-            (Rectangle){ 0, 0, (float)screenWidth, (float)screenHeight },
+            displayed,
+            (Rectangle){ 0, 0, (float)displayed.width, -(float)displayed.height },   // interne (accumulation) ou fenêtre (TAA)
+            (Rectangle){ 0, 0, (float)GetScreenWidth(), (float)GetScreenHeight() },
             (Vector2){ 0, 0 },
             0.0f,
             WHITE
         );
     EndShaderMode();
-EndTextureMode();
-//pour enlever les artefacts de la frame précédente
-if (frameCounter % 3 == 0) {
-    BeginTextureMode(renderHistory);
-        // On écrase totalement l'historique avec l'image courante (nettoyée)
-        DrawTextureRec(
-            denoiseTarget.texture,
-            (Rectangle){ 0, 0, (float)screenWidth, -(float)screenHeight },
-            (Vector2){ 0, 0 },
-            WHITE
-        );
-    EndTextureMode();
-}
-
-            //pour la derniere image
-            BeginTextureMode(renderHistory);
-                DrawTextureRec(
-                        taaOutput.texture,
-                        (Rectangle){ 0, 0, (float)screenWidth, -(float)screenHeight },
-                        (Vector2){ 0, 0 },
-                        WHITE
-                    );
-                EndTextureMode();
-                
-BeginDrawing();
-    //ClearBackground(BLACK); //faut pas mettre ça sinon ça assombrit l'image
-
-    // Dessiner le résultat du TAA
-    DrawTextureRec(
-        taaOutput.texture,
-        (Rectangle){ 0, 0, (float)screenWidth, -(float)screenHeight },
-        (Vector2){ 0, 0 },
-        WHITE
-    );
+    rlEnableColorBlend();
     
     // Affichage d'informations
     DrawFPS(10, 10);
     DrawText(TextFormat("Light Intensity: %.1f", lightIntensity), 10, 30, 20, WHITE);
+    DrawText(TextFormat("Adaptive sampling (V): %s", isAdaptive ? "on" : "off"), 10, 50, 20, WHITE);
+    DrawText(TextFormat("Sampler (N): %s", samplerTypeName(samplerType)), 10, 70, 20, WHITE);
+    DrawText(TextFormat("Scene uploads: %d", sceneUploader.uploadCount), 10, 90, 20, WHITE);
+    DrawText(TextFormat("Denoise iterations ([/]): %d, samples/pixel (,/.): %.2f", denoiser.iterations, samplesPerPixel),
+             10, 110, 20, WHITE);
+    DrawText(TextFormat("Progressive (P): %s, %d frames, light %s (Space), jitter (T): %s", progressive ? "on" : "off",
+                        progressive ? accumulator.frameCount : 0, animateLight ? "moving" : "paused",
+                        temporalJitter ? "halton" : "pixel"), 10, 130, 20, WHITE);
+    DrawText(TextFormat("Dynamic resolution (D): %s, %.0f%%, %.1f / %.1f ms, %d changes",
+                        resolutionController.enabled ? "on" : "off", 100.0f * resolutionControllerScale(&resolutionController),
+                        resolutionController.filteredMs, resolutionController.targetMs, resolutionController.changes),
+             10, 150, 20, WHITE);
+    if (showRenderPool) {
+        drawRenderPoolOverlay(&renderPool, 10, 180);
+        drawRenderPoolOverlay(&outputPool, 10, 180 + 20 * (renderPool.count + 3));
+    }
+    else DrawText(TextFormat("Render %dx%d, output %dx%d, targets (M)", renderWidth, renderHeight,
+                             outputPool.width, outputPool.height), 10, 170, 20, WHITE);
     DrawText("Controls:", 10, GetScreenHeight() - 90, 20, WHITE);
     DrawText("  Mouse Right - Rotate camera", 10, GetScreenHeight() - 70, 20, WHITE);
     DrawText("  Mouse Wheel - Zoom in/out", 10, GetScreenHeight() - 50, 20, WHITE);
     DrawText("  H/K/U/J/Y/I - Move light, +/- Change intensity", 10, GetScreenHeight() - 30, 20, WHITE);
+    if (showGpuTimings) drawGpuTimerOverlay(&gpuTimer, GetScreenWidth() - 480, 10);
+    else DrawText("GPU timings (G), log (L)", GetScreenWidth() - 260, 10, 20, WHITE);
+    endGpuPass(&gpuTimer);
 EndDrawing();
+endGpuFrame(&gpuTimer);
 
         frameCounter++;
 
     }
     
     // Nettoyage
+    unloadGpuTimer(&gpuTimer);
     UnloadShader(shader);
     UnloadShader(denoise_shader);
     UnloadShader(taa_shader);
-    UnloadRenderTexture(target); // Unload render texture
-    UnloadRenderTexture(renderNoisy);
-    UnloadRenderTexture(renderNormals);
-    UnloadRenderTexture(renderHistory);
-    UnloadRenderTexture(denoiseTarget);
+    UnloadShader(reproject_shader);
+    UnloadShader(tonemap_shader);
+    UnloadShader(accumulate_shader);
+    UnloadShader(sample_budget_shader);
+    UnloadShader(sample_budget_reduce_shader);
+    UnloadTexture(bvhTexture);
+    unloadSceneUploader(&sceneUploader);
+    unloadSceneSoA(&sceneSoA);  // sans effet sur une scène projetée (memory == NULL)
+    if (sceneFromFile) unloadSceneFile(&sceneFile);
+    unloadGBuffer(&gbuffer);
+    unloadSampleBudget(&sampleBudget);
+    unloadRenderPool(&renderPool);
+    unloadRenderPool(&outputPool);
     CloseWindow();
     
     return 0;
@@ -0,0 +1,264 @@
+#include "ray_packet.h"
+#include <math.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define RAY_PACKET_X86
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define TARGET_AVX2
+    #else
+        #define TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
+
+void initRayPacket(RayPacket *packet, int activeCount) {
+    for (int i = 0; i < RAY_PACKET_SIZE; i++) {
+        packet->invDx[i] = 1.0f / packet->dx[i];
+        packet->invDy[i] = 1.0f / packet->dy[i];
+        packet->invDz[i] = 1.0f / packet->dz[i];
+        packet->t[i] = (i < activeCount) ? 1e9f : 0.0f;
+        packet->hitIdx[i] = -1;
+        packet->hitType[i] = 0;
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Version scalaire (référence, identique à intersectSphere()/intersectBox() de raytest.fs)
+//------------------------------------------------------------------------------------
+static void intersectSphereScalar(RayPacket *p, float cx, float cy, float cz, float radius, int index) {
+    for (int i = 0; i < RAY_PACKET_SIZE; i++) {
+        float ocx = p->ox[i] - cx, ocy = p->oy[i] - cy, ocz = p->oz[i] - cz;
+        float b = ocx*p->dx[i] + ocy*p->dy[i] + ocz*p->dz[i];
+        float c = ocx*ocx + ocy*ocy + ocz*ocz - radius*radius;
+        float h = b*b - c;
+        if (h < 0.0f) continue;
+        h = sqrtf(h);
+        float t = -b - h;
+        if (t < 0.001f) t = -b + h;
+        if (t < 0.001f || !(t < p->t[i])) continue;
+        p->t[i] = t;
+        p->hitIdx[i] = index;
+        p->hitType[i] = 0;
+    }
+}
+
+static void intersectBoxScalar(RayPacket *p, const float boxMin[3], const float boxMax[3], int index) {
+    for (int i = 0; i < RAY_PACKET_SIZE; i++) {
+        float tx0 = (boxMin[0] - p->ox[i]) * p->invDx[i], tx1 = (boxMax[0] - p->ox[i]) * p->invDx[i];
+        float ty0 = (boxMin[1] - p->oy[i]) * p->invDy[i], ty1 = (boxMax[1] - p->oy[i]) * p->invDy[i];
+        float tz0 = (boxMin[2] - p->oz[i]) * p->invDz[i], tz1 = (boxMax[2] - p->oz[i]) * p->invDz[i];
+        float tmin = fmaxf(fmaxf(fminf(tx0, tx1), fminf(ty0, ty1)), fminf(tz0, tz1));
+        float tmax = fminf(fminf(fmaxf(tx0, tx1), fmaxf(ty0, ty1)), fmaxf(tz0, tz1));
+        if (tmin > tmax || tmax < 0.001f) continue;
+        float t = tmin > 0.001f ? tmin : tmax;
+        if (t < 0.001f || !(t < p->t[i])) continue;
+        p->t[i] = t;
+        p->hitIdx[i] = index;
+        p->hitType[i] = 1;
+    }
+}
+
+static int intersectBoundsScalar(const RayPacket *p, const float boxMin[3], const float boxMax[3]) {
+    int mask = 0;
+    for (int i = 0; i < RAY_PACKET_SIZE; i++) {
+        float tx0 = (boxMin[0] - p->ox[i]) * p->invDx[i], tx1 = (boxMax[0] - p->ox[i]) * p->invDx[i];
+        float ty0 = (boxMin[1] - p->oy[i]) * p->invDy[i], ty1 = (boxMax[1] - p->oy[i]) * p->invDy[i];
+        float tz0 = (boxMin[2] - p->oz[i]) * p->invDz[i], tz1 = (boxMax[2] - p->oz[i]) * p->invDz[i];
+        float tmin = fmaxf(fmaxf(fminf(tx0, tx1), fminf(ty0, ty1)), fminf(tz0, tz1));
+        float tmax = fminf(fminf(fmaxf(tx0, tx1), fmaxf(ty0, ty1)), fmaxf(tz0, tz1));
+        if (tmax >= tmin && tmin < p->t[i] && tmax > 0.0f) mask |= 1 << i;
+    }
+    return mask;
+}
+
+static const PacketKernels scalarKernels = {
+    "scalar", intersectSphereScalar, intersectBoxScalar, intersectBoundsScalar
+};
+
+#if defined(RAY_PACKET_X86)
+//------------------------------------------------------------------------------------
+// SSE2 : le paquet est traité en deux moitiés de 4 rayons (toujours disponible en x86-64)
+//------------------------------------------------------------------------------------
+static inline __m128 select4(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static void intersectSphereSSE(RayPacket *p, float cx, float cy, float cz, float radius, int index) {
+    const __m128 eps = _mm_set1_ps(0.001f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 r2 = _mm_set1_ps(radius*radius);
+    const __m128 idx = _mm_castsi128_ps(_mm_set1_epi32(index));
+    const __m128 type = _mm_castsi128_ps(_mm_setzero_si128());
+    for (int k = 0; k < RAY_PACKET_SIZE; k += 4) {
+        __m128 ocx = _mm_sub_ps(_mm_loadu_ps(p->ox + k), _mm_set1_ps(cx));
+        __m128 ocy = _mm_sub_ps(_mm_loadu_ps(p->oy + k), _mm_set1_ps(cy));
+        __m128 ocz = _mm_sub_ps(_mm_loadu_ps(p->oz + k), _mm_set1_ps(cz));
+        __m128 b = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ocx, _mm_loadu_ps(p->dx + k)), _mm_mul_ps(ocy, _mm_loadu_ps(p->dy + k))), _mm_mul_ps(ocz, _mm_loadu_ps(p->dz + k)));
+        __m128 c = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(ocx, ocx), _mm_mul_ps(ocy, ocy)), _mm_mul_ps(ocz, ocz)), r2);
+        __m128 h = _mm_sub_ps(_mm_mul_ps(b, b), c);
+        __m128 valid = _mm_cmpge_ps(h, zero);
+        h = _mm_sqrt_ps(_mm_max_ps(h, zero));
+        __m128 nb = _mm_sub_ps(zero, b);
+        __m128 tNear = _mm_sub_ps(nb, h);
+        __m128 t = select4(_mm_cmplt_ps(tNear, eps), _mm_add_ps(nb, h), tNear);
+        __m128 tCur = _mm_loadu_ps(p->t + k);
+        valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(t, eps), _mm_cmplt_ps(t, tCur)));
+        if (_mm_movemask_ps(valid) == 0) continue;
+        _mm_storeu_ps(p->t + k, select4(valid, t, tCur));
+        _mm_storeu_ps((float *)(p->hitIdx + k), select4(valid, idx, _mm_loadu_ps((const float *)(p->hitIdx + k))));
+        _mm_storeu_ps((float *)(p->hitType + k), select4(valid, type, _mm_loadu_ps((const float *)(p->hitType + k))));
+    }
+}
+
+// Entrée/sortie des trois dalles pour 4 rayons
+static inline void slabs4(const RayPacket *p, int k, const float boxMin[3], const float boxMax[3], __m128 *tmin, __m128 *tmax) {
+    __m128 ox = _mm_loadu_ps(p->ox + k), oy = _mm_loadu_ps(p->oy + k), oz = _mm_loadu_ps(p->oz + k);
+    __m128 ix = _mm_loadu_ps(p->invDx + k), iy = _mm_loadu_ps(p->invDy + k), iz = _mm_loadu_ps(p->invDz + k);
+    __m128 tx0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(boxMin[0]), ox), ix), tx1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(boxMax[0]), ox), ix);
+    __m128 ty0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(boxMin[1]), oy), iy), ty1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(boxMax[1]), oy), iy);
+    __m128 tz0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(boxMin[2]), oz), iz), tz1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(boxMax[2]), oz), iz);
+    *tmin = _mm_max_ps(_mm_max_ps(_mm_min_ps(tx0, tx1), _mm_min_ps(ty0, ty1)), _mm_min_ps(tz0, tz1));
+    *tmax = _mm_min_ps(_mm_min_ps(_mm_max_ps(tx0, tx1), _mm_max_ps(ty0, ty1)), _mm_max_ps(tz0, tz1));
+}
+
+static void intersectBoxSSE(RayPacket *p, const float boxMin[3], const float boxMax[3], int index) {
+    const __m128 eps = _mm_set1_ps(0.001f);
+    const __m128 idx = _mm_castsi128_ps(_mm_set1_epi32(index));
+    const __m128 type = _mm_castsi128_ps(_mm_set1_epi32(1));
+    for (int k = 0; k < RAY_PACKET_SIZE; k += 4) {
+        __m128 tmin, tmax;
+        slabs4(p, k, boxMin, boxMax, &tmin, &tmax);
+        __m128 miss = _mm_or_ps(_mm_cmpgt_ps(tmin, tmax), _mm_cmplt_ps(tmax, eps));
+        __m128 t = select4(_mm_cmpgt_ps(tmin, eps), tmin, tmax);
+        __m128 tCur = _mm_loadu_ps(p->t + k);
+        __m128 valid = _mm_andnot_ps(miss, _mm_and_ps(_mm_cmpge_ps(t, eps), _mm_cmplt_ps(t, tCur)));
+        if (_mm_movemask_ps(valid) == 0) continue;
+        _mm_storeu_ps(p->t + k, select4(valid, t, tCur));
+        _mm_storeu_ps((float *)(p->hitIdx + k), select4(valid, idx, _mm_loadu_ps((const float *)(p->hitIdx + k))));
+        _mm_storeu_ps((float *)(p->hitType + k), select4(valid, type, _mm_loadu_ps((const float *)(p->hitType + k))));
+    }
+}
+
+static int intersectBoundsSSE(const RayPacket *p, const float boxMin[3], const float boxMax[3]) {
+    int mask = 0;
+    for (int k = 0; k < RAY_PACKET_SIZE; k += 4) {
+        __m128 tmin, tmax;
+        slabs4(p, k, boxMin, boxMax, &tmin, &tmax);
+        __m128 valid = _mm_and_ps(_mm_cmpge_ps(tmax, tmin), _mm_and_ps(_mm_cmplt_ps(tmin, _mm_loadu_ps(p->t + k)), _mm_cmpgt_ps(tmax, _mm_setzero_ps())));
+        mask |= _mm_movemask_ps(valid) << k;
+    }
+    return mask;
+}
+
+static const PacketKernels sseKernels = {
+    "sse", intersectSphereSSE, intersectBoxSSE, intersectBoundsSSE
+};
+
+//------------------------------------------------------------------------------------
+// AVX2 : le paquet entier en une instruction (compilé avec l'attribut target, choisi à l'exécution)
+//------------------------------------------------------------------------------------
+TARGET_AVX2 static void intersectSphereAVX2(RayPacket *p, float cx, float cy, float cz, float radius, int index) {
+    const __m256 eps = _mm256_set1_ps(0.001f);
+    const __m256 zero = _mm256_setzero_ps();
+    __m256 ocx = _mm256_sub_ps(_mm256_loadu_ps(p->ox), _mm256_set1_ps(cx));
+    __m256 ocy = _mm256_sub_ps(_mm256_loadu_ps(p->oy), _mm256_set1_ps(cy));
+    __m256 ocz = _mm256_sub_ps(_mm256_loadu_ps(p->oz), _mm256_set1_ps(cz));
+    __m256 b = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ocx, _mm256_loadu_ps(p->dx)), _mm256_mul_ps(ocy, _mm256_loadu_ps(p->dy))), _mm256_mul_ps(ocz, _mm256_loadu_ps(p->dz)));
+    __m256 c = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ocx, ocx), _mm256_mul_ps(ocy, ocy)), _mm256_mul_ps(ocz, ocz)), _mm256_set1_ps(radius*radius));
+    __m256 h = _mm256_sub_ps(_mm256_mul_ps(b, b), c);
+    __m256 valid = _mm256_cmp_ps(h, zero, _CMP_GE_OQ);
+    if (_mm256_movemask_ps(valid) == 0) return;
+    h = _mm256_sqrt_ps(_mm256_max_ps(h, zero));
+    __m256 nb = _mm256_sub_ps(zero, b);
+    __m256 tNear = _mm256_sub_ps(nb, h);
+    __m256 t = _mm256_blendv_ps(tNear, _mm256_add_ps(nb, h), _mm256_cmp_ps(tNear, eps, _CMP_LT_OQ));
+    __m256 tCur = _mm256_loadu_ps(p->t);
+    valid = _mm256_and_ps(valid, _mm256_and_ps(_mm256_cmp_ps(t, eps, _CMP_GE_OQ), _mm256_cmp_ps(t, tCur, _CMP_LT_OQ)));
+    if (_mm256_movemask_ps(valid) == 0) return;
+    __m256i validi = _mm256_castps_si256(valid);
+    _mm256_storeu_ps(p->t, _mm256_blendv_ps(tCur, t, valid));
+    __m256i hitIdx = _mm256_loadu_si256((const __m256i *)p->hitIdx);
+    __m256i hitType = _mm256_loadu_si256((const __m256i *)p->hitType);
+    _mm256_storeu_si256((__m256i *)p->hitIdx, _mm256_blendv_epi8(hitIdx, _mm256_set1_epi32(index), validi));
+    _mm256_storeu_si256((__m256i *)p->hitType, _mm256_andnot_si256(validi, hitType));
+}
+
+TARGET_AVX2 static inline void slabs8(const RayPacket *p, const float boxMin[3], const float boxMax[3], __m256 *tmin, __m256 *tmax) {
+    __m256 ox = _mm256_loadu_ps(p->ox), oy = _mm256_loadu_ps(p->oy), oz = _mm256_loadu_ps(p->oz);
+    __m256 ix = _mm256_loadu_ps(p->invDx), iy = _mm256_loadu_ps(p->invDy), iz = _mm256_loadu_ps(p->invDz);
+    __m256 tx0 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(boxMin[0]), ox), ix), tx1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(boxMax[0]), ox), ix);
+    __m256 ty0 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(boxMin[1]), oy), iy), ty1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(boxMax[1]), oy), iy);
+    __m256 tz0 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(boxMin[2]), oz), iz), tz1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(boxMax[2]), oz), iz);
+    *tmin = _mm256_max_ps(_mm256_max_ps(_mm256_min_ps(tx0, tx1), _mm256_min_ps(ty0, ty1)), _mm256_min_ps(tz0, tz1));
+    *tmax = _mm256_min_ps(_mm256_min_ps(_mm256_max_ps(tx0, tx1), _mm256_max_ps(ty0, ty1)), _mm256_max_ps(tz0, tz1));
+}
+
+TARGET_AVX2 static void intersectBoxAVX2(RayPacket *p, const float boxMin[3], const float boxMax[3], int index) {
+    const __m256 eps = _mm256_set1_ps(0.001f);
+    __m256 tmin, tmax;
+    slabs8(p, boxMin, boxMax, &tmin, &tmax);
+    __m256 miss = _mm256_or_ps(_mm256_cmp_ps(tmin, tmax, _CMP_GT_OQ), _mm256_cmp_ps(tmax, eps, _CMP_LT_OQ));
+    __m256 t = _mm256_blendv_ps(tmax, tmin, _mm256_cmp_ps(tmin, eps, _CMP_GT_OQ));
+    __m256 tCur = _mm256_loadu_ps(p->t);
+    __m256 valid = _mm256_andnot_ps(miss, _mm256_and_ps(_mm256_cmp_ps(t, eps, _CMP_GE_OQ), _mm256_cmp_ps(t, tCur, _CMP_LT_OQ)));
+    if (_mm256_movemask_ps(valid) == 0) return;
+    __m256i validi = _mm256_castps_si256(valid);
+    _mm256_storeu_ps(p->t, _mm256_blendv_ps(tCur, t, valid));
+    __m256i hitIdx = _mm256_loadu_si256((const __m256i *)p->hitIdx);
+    __m256i hitType = _mm256_loadu_si256((const __m256i *)p->hitType);
+    _mm256_storeu_si256((__m256i *)p->hitIdx, _mm256_blendv_epi8(hitIdx, _mm256_set1_epi32(index), validi));
+    _mm256_storeu_si256((__m256i *)p->hitType, _mm256_blendv_epi8(hitType, _mm256_set1_epi32(1), validi));
+}
+
+TARGET_AVX2 static int intersectBoundsAVX2(const RayPacket *p, const float boxMin[3], const float boxMax[3]) {
+    __m256 tmin, tmax;
+    slabs8(p, boxMin, boxMax, &tmin, &tmax);
+    __m256 valid = _mm256_and_ps(_mm256_cmp_ps(tmax, tmin, _CMP_GE_OQ),
+                   _mm256_and_ps(_mm256_cmp_ps(tmin, _mm256_loadu_ps(p->t), _CMP_LT_OQ), _mm256_cmp_ps(tmax, _mm256_setzero_ps(), _CMP_GT_OQ)));
+    return _mm256_movemask_ps(valid);
+}
+
+static const PacketKernels avx2Kernels = {
+    "avx2", intersectSphereAVX2, intersectBoxAVX2, intersectBoundsAVX2
+};
+
+static bool cpuSupportsAVX2(void) {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx) return false;
+    // Le système doit sauvegarder les registres YMM
+    if ((_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif // RAY_PACKET_X86
+
+const PacketKernels *selectPacketKernels(void) {
+#if defined(RAY_PACKET_X86)
+    static const PacketKernels *selected = cpuSupportsAVX2() ? &avx2Kernels : &sseKernels;
+    return selected;
+#else
+    return &scalarKernels;
+#endif
+}
+
+const PacketKernels *findPacketKernels(const char *name) {
+    if (strcmp(name, "auto") == 0) return selectPacketKernels();
+    if (strcmp(name, "scalar") == 0) return &scalarKernels;
+#if defined(RAY_PACKET_X86)
+    if (strcmp(name, "sse") == 0) return &sseKernels;
+    if (strcmp(name, "avx2") == 0) return cpuSupportsAVX2() ? &avx2Kernels : NULL;
+#endif
+    return NULL;
+}
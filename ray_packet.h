@@ -0,0 +1,37 @@
+#ifndef RAY_PACKET_H
+#define RAY_PACKET_H
+
+// Paquets de 8 rayons cohérents (rayons caméra voisins) et noyaux d'intersection
+// vectorisés : AVX2 (8 rayons par instruction), SSE2 (2 x 4 rayons) ou scalaire.
+// L'implémentation est choisie à l'exécution selon CPUID.
+
+#define RAY_PACKET_SIZE 8
+
+// Disposition SoA pour charger chaque composante d'un seul coup
+typedef struct {
+    float ox[RAY_PACKET_SIZE], oy[RAY_PACKET_SIZE], oz[RAY_PACKET_SIZE];
+    float dx[RAY_PACKET_SIZE], dy[RAY_PACKET_SIZE], dz[RAY_PACKET_SIZE];
+    float invDx[RAY_PACKET_SIZE], invDy[RAY_PACKET_SIZE], invDz[RAY_PACKET_SIZE];
+    float t[RAY_PACKET_SIZE];       // impact le plus proche (1e9 = rien, 0 = rayon inactif)
+    int hitIdx[RAY_PACKET_SIZE];    // -1 = pas d'impact
+    int hitType[RAY_PACKET_SIZE];   // 0 = sphère, 1 = mur, 2 = triangle
+} RayPacket;
+
+typedef struct {
+    const char *name;
+    // Met à jour t/hitIdx/hitType des rayons du paquet qui touchent la primitive plus près
+    void (*intersectSphere)(RayPacket *packet, float cx, float cy, float cz, float radius, int index);
+    void (*intersectBox)(RayPacket *packet, const float boxMin[3], const float boxMax[3], int index);
+    // Masque (bit i = rayon i) des rayons qui entrent dans la boîte avant leur impact courant
+    int (*intersectBounds)(const RayPacket *packet, const float boxMin[3], const float boxMax[3]);
+} PacketKernels;
+
+// Calcule les inverses des directions et réinitialise les impacts (lanes >= activeCount inactives)
+void initRayPacket(RayPacket *packet, int activeCount);
+
+// Meilleure implémentation supportée par le processeur
+const PacketKernels *selectPacketKernels(void);
+// Implémentation par nom ("scalar", "sse", "avx2"), NULL si inconnue ou non supportée
+const PacketKernels *findPacketKernels(const char *name);
+
+#endif // RAY_PACKET_H
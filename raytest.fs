@@ -1,9 +1,28 @@
 #version 330
-#define MAX_SPHERES 8
-#define MAX_BLOCKS 6
 #define MAX_BOUNCES 5  // Augmenté pour plus de réalisme
-#define MAX_SAMPLES 8  // Anti-aliasing
+#define MAX_SAMPLES 8  // strates du jitter en mode SAMPLER_HASH
+#define ADAPTIVE_MIN_SAMPLES 4   // échantillons avant le premier test de convergence
+#define ADAPTIVE_MAX_SAMPLES 16  // plafond des pixels bruités en mode adaptatif
+#define ADAPTIVE_UNIFORM_WEIGHT 0.5 // part uniforme de la répartition (identique à cpu_tracer.h)
 #define PI 3.14159265
+#define BVH_TEXTURE_WIDTH 1024 // identique à bvh.h
+#define SCENE_TEXTURE_WIDTH 1024 // identique à scene_soa.h
+#define BVH_STACK_SIZE 32
+
+// Échantillonneurs (identiques à sampler.h)
+#define SAMPLER_HASH 0
+#define SAMPLER_SOBOL 1
+#define SAMPLER_RANK1 2
+#define SAMPLER_DIM_CAMERA 0
+#define SAMPLER_DIM_BOUNCE 1
+#define SAMPLER_BOUNCE_DIMS 16
+#define SAMPLER_DIM_SCATTER 0
+#define SAMPLER_DIM_FRESNEL 1
+#define SAMPLER_DIM_ROULETTE 2
+#define SAMPLER_DIM_REFRACT 3
+#define SAMPLER_DIM_LIGHT 4
+#define SAMPLER_LIGHT_DIMS (SAMPLER_BOUNCE_DIMS - SAMPLER_DIM_LIGHT)
+#define R2_ALPHA vec2(0.7548776662466927, 0.5698402909980532)
 
 // Structures de matériaux
 #define MAT_DIFFUSE 0
@@ -31,16 +50,17 @@ struct Hit {
     int blockId;
 };
 
-uniform vec4 spheres[MAX_SPHERES];     // xyz = position, w = rayon
-uniform Material materials[MAX_SPHERES]; // Matériaux des sphères
+//Scène dans une texture RGBA32F (disposition dans scene_soa.h) : sphères (position,
+//rayon, matériau), blocs (centre, taille, matériau), triangles (sommets, matériau)
+//puis indices des sphères émissives
+uniform sampler2D sceneTexture;
 uniform int sphereCount;
-
-uniform vec3 blocks[MAX_BLOCKS]; // Positions des blocs (pour les murs)
-uniform vec3 blockSizes[MAX_BLOCKS]; // Tailles des blocs
-uniform Material materials_block[MAX_BLOCKS]; // Matériaux des murs
 uniform int blockCount;
-//pour les lumières sur les murs
-uniform vec3 emission_block[MAX_BLOCKS]; // intensité RGB de lumière émise par le bloc
+uniform int triangleCount;
+uniform int lightCount;       // nombre de sphères émissives
+uniform int sceneBlockOffset; // premier texel des blocs
+uniform int sceneTriangleOffset; // premier texel des triangles
+uniform int sceneLightOffset; // premier texel de la liste des lumières
 
 uniform vec3 lightPos;
 uniform vec3 lightColor;
@@ -48,13 +68,66 @@ uniform float lightIntensity;
 uniform vec2 resolution;
 uniform vec3 viewEye;
 uniform vec3 viewCenter;
+uniform vec3 prevViewEye;     // caméra de la frame précédente (vecteurs de mouvement)
+uniform vec3 prevViewCenter;
 uniform float time;     // Pour le bruit
+uniform float adaptiveThreshold; // 0 = samplesPerPixel fixes, sinon écart type de la moyenne visé
+uniform float samplesPerPixel;   // budget par frame, 0.25 à ADAPTIVE_MAX_SAMPLES (partie fractionnaire en damier)
+uniform int frameIndex;          // fait tourner le damier des budgets fractionnaires
+uniform sampler2D sampleBudget;  // mode adaptatif : écart type par pixel de la frame précédente (r)
+uniform sampler2D sampleBudgetState; // 1x1 : facteur d'échelle (r), écart type moyen (g) (sample_budget.h)
+uniform int useSampleBudget;     // 0 : samplesPerPixel pour tous les pixels
+uniform int samplerType;         // SAMPLER_HASH, SAMPLER_SOBOL ou SAMPLER_RANK1
+uniform int samplerSeed;         // graine des suites Sobol et rang 1 (fixe pendant une accumulation)
+uniform int sampleOffset;        // premier indice d'échantillon de la frame (accumulation progressive)
+uniform vec2 cameraJitter;       // décalage sous-pixel de la frame (Halton 2, 3), en pixels, retiré par taa.fs
+uniform int pixelJitter;         // 1 : chaque échantillon tiré ailleurs dans le pixel (accumulation),
+                                 // 0 : tous au point cameraJitter, l'anti-aliasing vient du TAA
+
+//BVH aplati (voir bvh.h) : 2 texels par noeud puis une référence de primitive par texel
+uniform sampler2D bvhTexture;
+uniform int bvhNodeCount;  // 0 = boucles linéaires
+uniform int bvhPrimOffset; // premier texel des références de primitives
+
+
+// Sorties (attachements du G-buffer, voir gbuffer.h)
+layout(location = 0) out vec4 finalColor;
+layout(location = 1) out vec4 gNormalDepth;     // normale du premier impact, profondeur linéaire (0 = ciel)
+layout(location = 2) out vec4 gAlbedoMaterial;  // albedo et type de matériau (-1 = ciel)
+layout(location = 3) out vec4 gMotion;          // uv - uv précédent, profondeur précédente attendue, validité
+
+vec4 sceneTexel(int i) {
+    return texelFetch(sceneTexture, ivec2(i % SCENE_TEXTURE_WIDTH, i / SCENE_TEXTURE_WIDTH), 0);
+}
 
-uniform sampler2D previousFrame;
-uniform float frameBlend; // 0.1 to 0.2 works well
+// Deux texels : (albedo, type) (rugosité, ior, 0, 0)
+Material loadMaterial(int texel) {
+    vec4 a = sceneTexel(texel);
+    vec4 b = sceneTexel(texel + 1);
+    Material mat;
+    mat.type = int(a.w);
+    mat.roughness = b.x;
+    mat.ior = b.y;
+    mat.padding = 0.0;
+    mat.albedo = a.xyz;
+    mat.padding2 = 0.0;
+    return mat;
+}
 
+vec4 sphereAt(int i) { return sceneTexel(3 * i); }              // xyz = position, w = rayon
+Material sphereMaterial(int i) { return loadMaterial(3 * i + 1); }
+vec3 blockCenter(int i) { return sceneTexel(sceneBlockOffset + 4 * i).xyz; }
+vec3 blockSize(int i) { return sceneTexel(sceneBlockOffset + 4 * i + 1).xyz; }
+Material blockMaterial(int i) { return loadMaterial(sceneBlockOffset + 4 * i + 2); }
+vec3 triangleVertex(int i, int k) { return sceneTexel(sceneTriangleOffset + 5 * i + k).xyz; }
+Material triangleMaterial(int i) { return loadMaterial(sceneTriangleOffset + 5 * i + 3); }
 
-out vec4 finalColor;
+// Indice de la l-ième sphère émissive (4 indices par texel)
+int lightSphere(int l) {
+    vec4 t = sceneTexel(sceneLightOffset + l / 4);
+    int k = l % 4;
+    return int(k == 0 ? t.x : (k == 1 ? t.y : (k == 2 ? t.z : t.w)));
+}
 
 // Hash function pour générer des nombres pseudo-aléatoires
 uint hash(uint x) {
@@ -77,9 +150,102 @@ vec2 randomVec2(vec3 pos, float seed) {
     );
 }
 
+// État de l'échantillon courant du pixel (voir sampler.cpp)
+struct PathSampler {
+    uint frameSeed;   // dépend de samplerSeed seulement
+    uint pixelSeed;   // dépend du pixel et de samplerSeed
+    uint index;       // numéro de l'échantillon
+    vec2 pixelOffset; // masque R2 du pixel
+};
+PathSampler pathSampler;
+
+uint reverseBits(uint x) {
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0f0f0f0fu) | ((x & 0x0f0f0f0fu) << 4);
+    x = ((x >> 8) & 0x00ff00ffu) | ((x & 0x00ff00ffu) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+// Permutation de Laine-Karras puis brouillage d'Owen par hachage (Burley 2020)
+uint laineKarrasPermutation(uint x, uint seed) {
+    x += seed;
+    x ^= x * 0x6c50b47cu;
+    x ^= x * 0xb82f1e52u;
+    x ^= x * 0xc7afe638u;
+    x ^= x * 0x8d22f6e6u;
+    return x;
+}
+
+uint nestedUniformScramble(uint x, uint seed) {
+    return reverseBits(laineKarrasPermutation(reverseBits(x), seed));
+}
+
+// Deuxième dimension de Sobol, la première est reverseBits(index)
+uint sobolSecond(uint index) {
+    uint result = 0u;
+    uint v = 0x80000000u;
+    for (int i = 0; i < 32; ++i) {
+        if (index == 0u) break;
+        if ((index & 1u) != 0u) result ^= v;
+        index >>= 1;
+        v ^= v >> 1;
+    }
+    return result;
+}
+
+float toUnitFloat(uint x) {
+    return float(x >> 8) * (1.0 / 16777216.0);
+}
+
+void initPathSampler(ivec2 pixel, int index) {
+    pathSampler.frameSeed = hash(uint(samplerSeed));
+    pathSampler.pixelSeed = hash(uint(pixel.x) ^ hash(uint(pixel.y) ^ pathSampler.frameSeed));
+    pathSampler.index = uint(sampleOffset + index);
+    pathSampler.pixelOffset = fract(vec2(pixel) * R2_ALPHA.x + vec2(pixel.yx) * R2_ALPHA.y);
+}
+
+vec2 sampleLowDiscrepancy(int dimension) {
+    uint dimensionHash = hash(uint(dimension) + 1u);
+
+    if (samplerType == SAMPLER_RANK1) {
+        // Décalage par dimension commun à tous les pixels : la structure du masque est conservée
+        uint seed = pathSampler.frameSeed ^ dimensionHash;
+        vec2 shift = vec2(toUnitFloat(hash(seed)), toUnitFloat(hash(seed ^ 0x9e3779b9u)));
+        return fract(pathSampler.pixelOffset + shift + float(pathSampler.index) * R2_ALPHA);
+    }
+
+    // Sobol-Owen : indice mélangé par dimension puis chaque composante brouillée
+    uint seed = hash(pathSampler.pixelSeed ^ dimensionHash);
+    uint shuffled = nestedUniformScramble(pathSampler.index, seed);
+    uint x = nestedUniformScramble(reverseBits(shuffled), hash(seed ^ 0xa511e9b3u));
+    uint y = nestedUniformScramble(sobolSecond(shuffled), hash(seed ^ 0x63d83595u));
+    return vec2(toUnitFloat(x), toUnitFloat(y));
+}
+
+// Tirages d'une dimension du chemin (pos et seed ne servent qu'au mode SAMPLER_HASH)
+vec2 sample2D(int dimension, vec3 pos, float seed) {
+    if (samplerType == SAMPLER_HASH) return randomVec2(pos, seed);
+    return sampleLowDiscrepancy(dimension);
+}
+
+float sample1D(int dimension, vec3 pos, float seed) {
+    if (samplerType == SAMPLER_HASH) return random(pos, seed);
+    return sampleLowDiscrepancy(dimension).x;
+}
+
+int samplerBounceDim(int bounce, int dim) {
+    return SAMPLER_DIM_BOUNCE + bounce * SAMPLER_BOUNCE_DIMS + dim;
+}
+
+// Rang de la lumière modulo SAMPLER_LIGHT_DIMS : reste dans les dimensions du rebond
+int samplerLightDim(int bounce, int light) {
+    return samplerBounceDim(bounce, SAMPLER_DIM_LIGHT + light % SAMPLER_LIGHT_DIMS);
+}
+
 // Échantillonnage cosinus pondéré pour une meilleure distribution
-vec3 sampleHemisphere(vec3 normal, vec3 pos, float seed) {
-    vec2 rand = randomVec2(pos, seed);
+vec3 sampleHemisphere(vec3 normal, vec3 pos, float seed, int dimension) {
+    vec2 rand = sample2D(dimension, pos, seed);
     
     float phi = 2.0 * PI * rand.x;
     float cosTheta = sqrt(rand.y);  // Distribution en cosinus
@@ -97,11 +263,11 @@ vec3 sampleHemisphere(vec3 normal, vec3 pos, float seed) {
 }
 
 // Réflexion spéculaire avec perturbation pour rugosité
-vec3 reflect_custom(vec3 incident, vec3 normal, float roughness, vec3 pos, float seed) {
+vec3 reflect_custom(vec3 incident, vec3 normal, float roughness, vec3 pos, float seed, int dimension) {
     vec3 reflected = reflect(incident, normal);
     
     if (roughness > 0.0) {
-        vec2 rand = randomVec2(pos, seed);
+        vec2 rand = sample2D(dimension, pos, seed);
         float phi = 2.0 * PI * rand.x;
         float cosTheta = pow(1.0 - rand.y * roughness * roughness, 1.0 / 3.0);
         float sinTheta = sqrt(1.0 - cosTheta * cosTheta);
@@ -120,7 +286,7 @@ vec3 reflect_custom(vec3 incident, vec3 normal, float roughness, vec3 pos, float
 }
 
 // Réfraction avec loi de Fresnel et perturbation pour rugosité
-vec3 refract(vec3 incident, vec3 normal, float ior, float roughness, vec3 pos, float seed, out float reflectionChance) {
+vec3 refract(vec3 incident, vec3 normal, float ior, float roughness, vec3 pos, float seed, int bounce, out float reflectionChance) {
     float eta = dot(incident, normal) < 0.0 ? 1.0 / ior : ior;
     vec3 n = dot(incident, normal) < 0.0 ? normal : -normal;
     
@@ -130,7 +296,7 @@ vec3 refract(vec3 incident, vec3 normal, float ior, float roughness, vec3 pos, f
     // Réflexion totale interne
     if (sinT2 > 1.0) {
         reflectionChance = 1.0;
-        return reflect_custom(incident, n, roughness, pos, seed);
+        return reflect_custom(incident, n, roughness, pos, seed, samplerBounceDim(bounce, SAMPLER_DIM_SCATTER));
     }
     
     float cosT = sqrt(1.0 - sinT2);
@@ -141,14 +307,14 @@ vec3 refract(vec3 incident, vec3 normal, float ior, float roughness, vec3 pos, f
     
     reflectionChance = fresnel;
     
-    if (random(pos, seed + 4.269) < fresnel) {
-        return reflect_custom(incident, n, roughness, pos, seed);
+    if (sample1D(samplerBounceDim(bounce, SAMPLER_DIM_FRESNEL), pos, seed + 4.269) < fresnel) {
+        return reflect_custom(incident, n, roughness, pos, seed, samplerBounceDim(bounce, SAMPLER_DIM_SCATTER));
     }
     
     vec3 refracted = normalize(eta * incident + (eta * cosI - cosT) * n);
     
     if (roughness > 0.0) {
-        vec2 rand = randomVec2(pos, seed + 2.718);
+        vec2 rand = sample2D(samplerBounceDim(bounce, SAMPLER_DIM_REFRACT), pos, seed + 2.718);
         float phi = 2.0 * PI * rand.x;
         float cosTheta = pow(1.0 - rand.y * roughness * roughness, 1.0 / 2.0);
         float sinTheta = sqrt(1.0 - cosTheta * cosTheta);
@@ -220,6 +386,139 @@ bool intersectBox(vec3 ro, vec3 rd, vec3 boxMin, vec3 boxMax, out float t, out v
     return true;
 }
 
+// Möller-Trumbore, normale géométrique non retournée (le verre distingue entrée et sortie)
+bool intersectTriangle(vec3 ro, vec3 rd, vec3 v0, vec3 v1, vec3 v2, out float t, out vec3 n) {
+    vec3 e1 = v1 - v0;
+    vec3 e2 = v2 - v0;
+    vec3 p = cross(rd, e2);
+    float det = dot(e1, p);
+    if (abs(det) < 1e-12) return false;
+
+    float invDet = 1.0 / det;
+    vec3 s = ro - v0;
+    float u = dot(s, p) * invDet;
+    if (u < 0.0 || u > 1.0) return false;
+    vec3 q = cross(s, e1);
+    float v = dot(rd, q) * invDet;
+    if (v < 0.0 || u + v > 1.0) return false;
+
+    t = dot(e2, q) * invDet;
+    if (t < 0.001) return false;
+
+    n = normalize(cross(e1, e2));
+    return true;
+}
+
+bool intersectTriangleAt(vec3 ro, vec3 rd, int i, out float t, out vec3 n) {
+    return intersectTriangle(ro, rd, triangleVertex(i, 0), triangleVertex(i, 1), triangleVertex(i, 2), t, n);
+}
+
+vec4 bvhTexel(int i) {
+    return texelFetch(bvhTexture, ivec2(i % BVH_TEXTURE_WIDTH, i / BVH_TEXTURE_WIDTH), 0);
+}
+
+// Distance d'entrée dans la boîte englobante, 1e30 si pas d'intersection avant maxT
+float intersectBounds(vec3 ro, vec3 invDir, vec3 bmin, vec3 bmax, float maxT) {
+    vec3 t0 = (bmin - ro) * invDir;
+    vec3 t1 = (bmax - ro) * invDir;
+    vec3 tsmaller = min(t0, t1);
+    vec3 tbigger = max(t0, t1);
+    float tmin = max(max(tsmaller.x, tsmaller.y), tsmaller.z);
+    float tmax = min(min(tbigger.x, tbigger.y), tbigger.z);
+    return (tmax >= tmin && tmin < maxT && tmax > 0.0) ? tmin : 1e30;
+}
+
+// Parcours du BVH avec pile pour trouver l'intersection la plus proche
+void traverseBvh(vec3 ro, vec3 rd, inout float minT, inout vec3 n, inout int hitIdx, inout int hitType) {
+    vec3 invDir = 1.0 / rd;
+    int stack[BVH_STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        int nodeIdx = stack[--stackSize];
+        vec4 a = bvhTexel(2 * nodeIdx);
+        vec4 b = bvhTexel(2 * nodeIdx + 1);
+        if (intersectBounds(ro, invDir, a.xyz, b.xyz, minT) >= 1e30) continue;
+
+        int leftFirst = int(a.w);
+        int count = int(b.w);
+        if (count > 0) {
+            for (int k = 0; k < count; ++k) {
+                vec4 ref = bvhTexel(bvhPrimOffset + leftFirst + k);
+                int i = int(ref.x);
+                float t;
+                vec3 ni;
+                int type = int(ref.y);
+                if (type == 0) {
+                    if (intersectSphere(ro, rd, sphereAt(i), t, ni) && t < minT) {
+                        minT = t; n = ni; hitIdx = i; hitType = 0;
+                    }
+                } else if (type == 1) {
+                    vec3 center = blockCenter(i);
+                    vec3 halfSize = blockSize(i) * 0.5;
+                    if (intersectBox(ro, rd, center - halfSize, center + halfSize, t, ni) && t < minT) {
+                        minT = t; n = ni; hitIdx = i; hitType = 1;
+                    }
+                } else {
+                    if (intersectTriangleAt(ro, rd, i, t, ni) && t < minT) {
+                        minT = t; n = ni; hitIdx = i; hitType = 2;
+                    }
+                }
+            }
+        } else {
+            // Fils le plus proche empilé en dernier pour être visité en premier
+            vec4 la = bvhTexel(2 * leftFirst);
+            vec4 lb = bvhTexel(2 * leftFirst + 1);
+            vec4 ra = bvhTexel(2 * leftFirst + 2);
+            vec4 rb = bvhTexel(2 * leftFirst + 3);
+            float tLeft = intersectBounds(ro, invDir, la.xyz, lb.xyz, minT);
+            float tRight = intersectBounds(ro, invDir, ra.xyz, rb.xyz, minT);
+            int nearChild = tLeft <= tRight ? leftFirst : leftFirst + 1;
+            int farChild = tLeft <= tRight ? leftFirst + 1 : leftFirst;
+            if (max(tLeft, tRight) < 1e30) stack[stackSize++] = farChild;
+            if (min(tLeft, tRight) < 1e30) stack[stackSize++] = nearChild;
+        }
+    }
+}
+
+// Rayon d'ombre via le BVH : seuls les sphères (sauf skipSphere) et les triangles occultent
+bool occludedBvh(vec3 ro, vec3 rd, float maxT, int skipSphere) {
+    vec3 invDir = 1.0 / rd;
+    int stack[BVH_STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        int nodeIdx = stack[--stackSize];
+        vec4 a = bvhTexel(2 * nodeIdx);
+        vec4 b = bvhTexel(2 * nodeIdx + 1);
+        if (intersectBounds(ro, invDir, a.xyz, b.xyz, maxT) >= 1e30) continue;
+
+        int leftFirst = int(a.w);
+        int count = int(b.w);
+        if (count > 0) {
+            for (int k = 0; k < count; ++k) {
+                vec4 ref = bvhTexel(bvhPrimOffset + leftFirst + k);
+                int i = int(ref.x);
+                int type = int(ref.y);
+                float t;
+                vec3 tmp;
+                if (type == 2) {
+                    if (intersectTriangleAt(ro, rd, i, t, tmp) && t < maxT) return true;
+                    continue;
+                }
+                if (type != 0 || i == skipSphere) continue;
+                if (intersectSphere(ro, rd, sphereAt(i), t, tmp) && t < maxT) return true;
+            }
+        } else {
+            stack[stackSize++] = leftFirst;
+            stack[stackSize++] = leftFirst + 1;
+        }
+    }
+    return false;
+}
+
 Hit intersectScene(vec3 ro, vec3 rd) {
     Hit closestHit;
     closestHit.hit = false;
@@ -228,8 +527,8 @@ Hit intersectScene(vec3 ro, vec3 rd) {
     for (int i = 0; i < blockCount; ++i) {
         float t;
         vec3 n;
-        vec3 boxMin = blocks[i];
-        vec3 boxMax = blocks[i] + blockSizes[i];
+        vec3 boxMin = blockCenter(i);
+        vec3 boxMax = blockCenter(i) + blockSize(i);
 
         if (intersectBox(ro, rd, boxMin, boxMax, t, n)) {
             if (t < closestHit.t) {
@@ -237,7 +536,7 @@ Hit intersectScene(vec3 ro, vec3 rd) {
                 closestHit.t = t;
                 closestHit.normal = n;
                 closestHit.blockId = i;
-                closestHit.matId = materials_block[i];
+                closestHit.matId = blockMaterial(i);
             }
         }
     }
@@ -255,7 +554,7 @@ vec3 directLight(vec3 p, vec3 n, vec3 viewDir, int matType, vec3 albedo, float r
     for (int i = 0; i < sphereCount; ++i) {
         float t;
         vec3 tmp;
-        if (intersectSphere(p + n * 0.001, toLight, spheres[i], t, tmp)) {
+        if (intersectSphere(p + n * 0.001, toLight, sphereAt(i), t, tmp)) {
             if (t < distToLight) {
                 occluded = true;
                 break;
@@ -268,9 +567,9 @@ vec3 directLight(vec3 p, vec3 n, vec3 viewDir, int matType, vec3 albedo, float r
         for (int i = 0; i < blockCount; ++i) {
             float t;
             vec3 tmp;
-            vec3 halfSize = blockSizes[i] * 0.5;
-            vec3 blockMin = blocks[i] - halfSize;
-            vec3 blockMax = blocks[i] + halfSize;
+            vec3 halfSize = blockSize(i) * 0.5;
+            vec3 blockMin = blockCenter(i) - halfSize;
+            vec3 blockMax = blockCenter(i) + halfSize;
 
             if (intersectBox(p + n * 0.001, toLight, blockMin, blockMax, t, tmp)) {
                 if (t < distToLight) {
@@ -326,85 +625,96 @@ vec3 directLight(vec3 p, vec3 n, vec3 viewDir, int matType, vec3 albedo, float r
 }
 
 //fonction d'échantillonnage direct de la lumière
-vec3 sampleDirectLight(vec3 p, vec3 n, vec3 viewDir, Material mat, float seed) {
+vec3 sampleDirectLight(vec3 p, vec3 n, vec3 viewDir, Material mat, float seed, int bounce) {
     // Éviter l'auto-intersection avec un petit décalage
     vec3 origin = p + n * 0.001;
     vec3 contrib = vec3(0.0);
     
-    // Trouver les sources de lumière émissives (sphères)
-    for (int i = 0; i < sphereCount; ++i) {
-        if (materials[i].type == MAT_EMISSIVE) {
-            // Échantillonnage de la sphère lumineuse
-            vec3 lightCenter = spheres[i].xyz;
-            float lightRadius = spheres[i].w;
-            float distToLight = length(lightCenter - p);
-            
-            // Génération d'un point aléatoire sur la sphère lumineuse
-            vec2 rand = randomVec2(p, seed + float(i) * 0.773);
-            float phi = 2.0 * PI * rand.x;
-            float cosTheta = 2.0 * rand.y - 1.0;
-            float sinTheta = sqrt(1.0 - cosTheta * cosTheta);
-            
-            vec3 sampleOffset = lightRadius * vec3(
-                cos(phi) * sinTheta,
-                sin(phi) * sinTheta,
-                cosTheta
-            );
-            
-            vec3 lightPos = lightCenter + sampleOffset;
-            vec3 toLight = normalize(lightPos - p);
-            
-            // Vérifier la visibilité (ombres)
-            bool occluded = false;
-            for (int j = 0; j < sphereCount; ++j) {
-                if (j == i) continue; // Ignorer la source
-                float t;
-                vec3 tmp;
-                if (intersectSphere(origin, toLight, spheres[j], t, tmp)) {
-                    if (t < distToLight) {
-                        occluded = true;
-                        break;
-                    }
+    // Sphères émissives (liste de la texture de scène, dans l'ordre des indices)
+    for (int l = 0; l < lightCount; ++l) {
+        int i = lightSphere(l);
+        // Échantillonnage de la sphère lumineuse
+        vec4 lightSphereData = sphereAt(i);
+        vec3 lightCenter = lightSphereData.xyz;
+        float lightRadius = lightSphereData.w;
+        float distToLight = length(lightCenter - p);
+        
+        // Génération d'un point aléatoire sur la sphère lumineuse
+        vec2 rand = sample2D(samplerLightDim(bounce, l), p, seed + float(i) * 0.773);
+        float phi = 2.0 * PI * rand.x;
+        float cosTheta = 2.0 * rand.y - 1.0;
+        float sinTheta = sqrt(1.0 - cosTheta * cosTheta);
+        
+        vec3 sampleOffset = lightRadius * vec3(
+            cos(phi) * sinTheta,
+            sin(phi) * sinTheta,
+            cosTheta
+        );
+        
+        vec3 lightPos = lightCenter + sampleOffset;
+        vec3 toLight = normalize(lightPos - p);
+        
+        // Vérifier la visibilité (ombres)
+        bool occluded = false;
+        if (bvhNodeCount > 0) {
+            occluded = occludedBvh(origin, toLight, distToLight, i);
+        }
+        else for (int j = 0; j < sphereCount; ++j) {
+            if (j == i) continue; // Ignorer la source
+            float t;
+            vec3 tmp;
+            if (intersectSphere(origin, toLight, sphereAt(j), t, tmp)) {
+                if (t < distToLight) {
+                    occluded = true;
+                    break;
                 }
             }
+        }
+        if (bvhNodeCount == 0 && !occluded) for (int j = 0; j < triangleCount; ++j) {
+            float t;
+            vec3 tmp;
+            if (intersectTriangleAt(origin, toLight, j, t, tmp) && t < distToLight) {
+                occluded = true;
+                break;
+            }
+        }
+        
+        if (!occluded) {
+            // Calculer la contribution de cette lumière
+            float solidAngle = 2.0 * PI * (1.0 - sqrt(1.0 - (lightRadius*lightRadius)/(distToLight*distToLight)));
+            float cosLight = max(0.0, dot(n, toLight));
             
-            if (!occluded) {
-                // Calculer la contribution de cette lumière
-                float solidAngle = 2.0 * PI * (1.0 - sqrt(1.0 - (lightRadius*lightRadius)/(distToLight*distToLight)));
+            // BRDF selon le matériau
+            vec3 brdf = vec3(0.0);
+            if (mat.type == MAT_DIFFUSE) {
+                brdf = mat.albedo / PI; // Lambert
+            }
+            else if (mat.type == MAT_METALLIC) {
+                vec3 halfwayDir = normalize(toLight + viewDir);
+                float spec = pow(max(dot(n, halfwayDir), 0.0), (1.0 - mat.roughness) * 128.0 + 1.0);
+                brdf = (mat.albedo + spec * (1.0 - mat.roughness)) / PI;
+            }
+            else if (mat.type == MAT_GLASS) {
+                // Approximation simple pour le verre
+                vec3 reflectDir = reflect(-toLight, n);
+                float spec = pow(max(dot(viewDir, reflectDir), 0.0), (1.0 - mat.roughness) * 128.0 + 1.0);
+                brdf = vec3(spec * (1.0 - mat.roughness)) / PI;
+            }
+            else if (mat.type == MAT_MIRROR) {
+                vec3 reflectDir = reflect(-toLight, n);
+                float spec = pow(max(dot(viewDir, reflectDir), 0.0), (1.0 - mat.roughness) * 128.0 + 1.0);
+                brdf = vec3(spec * (1.0 - mat.roughness)) / PI;
+            }
+            // Calcul du PDF
+            float distance2 = dot(lightPos - p, lightPos - p);
+            float cosTheta = max(dot(toLight, -normalize(sampleOffset)), 0.0);
+            float pdf = distance2 / (cosTheta * 4.0 * PI * lightRadius * lightRadius + 0.001); // éviter /0
+
+            // Contribution lumineuse si pdf valide
+            if (pdf > 0.0) {
+                vec3 Li = sphereMaterial(i).albedo * lightIntensity;
                 float cosLight = max(0.0, dot(n, toLight));
-                
-                // BRDF selon le matériau
-                vec3 brdf = vec3(0.0);
-                if (mat.type == MAT_DIFFUSE) {
-                    brdf = mat.albedo / PI; // Lambert
-                }
-                else if (mat.type == MAT_METALLIC) {
-                    vec3 halfwayDir = normalize(toLight + viewDir);
-                    float spec = pow(max(dot(n, halfwayDir), 0.0), (1.0 - mat.roughness) * 128.0 + 1.0);
-                    brdf = (mat.albedo + spec * (1.0 - mat.roughness)) / PI;
-                }
-                else if (mat.type == MAT_GLASS) {
-                    // Approximation simple pour le verre
-                    vec3 reflectDir = reflect(-toLight, n);
-                    float spec = pow(max(dot(viewDir, reflectDir), 0.0), (1.0 - mat.roughness) * 128.0 + 1.0);
-                    brdf = vec3(spec * (1.0 - mat.roughness)) / PI;
-                }
-                else if (mat.type == MAT_MIRROR) {
-                    vec3 reflectDir = reflect(-toLight, n);
-                    float spec = pow(max(dot(viewDir, reflectDir), 0.0), (1.0 - mat.roughness) * 128.0 + 1.0);
-                    brdf = vec3(spec * (1.0 - mat.roughness)) / PI;
-                }
-                // Calcul du PDF
-                float distance2 = dot(lightPos - p, lightPos - p);
-                float cosTheta = max(dot(toLight, -normalize(sampleOffset)), 0.0);
-                float pdf = distance2 / (cosTheta * 4.0 * PI * lightRadius * lightRadius + 0.001); // éviter /0
-
-                // Contribution lumineuse si pdf valide
-                if (pdf > 0.0) {
-                    vec3 Li = materials[i].albedo * lightIntensity;
-                    float cosLight = max(0.0, dot(n, toLight));
-                    contrib += brdf * Li * cosLight / pdf;
-                }
+                contrib += brdf * Li * cosLight / pdf;
             }
         }
     }
@@ -450,6 +760,73 @@ float emissionPattern(vec3 hitPos, vec3 blockMin, vec3 blockMax, float time) {
 
 
 
+// Intersection la plus proche (BVH ou boucles linéaires), hitIdx = -1 si rien
+void intersectClosest(vec3 ro, vec3 rd, inout float minT, inout vec3 n, inout int hitIdx, inout int hitType) {
+    if (bvhNodeCount > 0) {
+        traverseBvh(ro, rd, minT, n, hitIdx, hitType);
+    }
+    else for (int i = 0; i < sphereCount; ++i) {
+        float t;
+        vec3 ni;
+        if (intersectSphere(ro, rd, sphereAt(i), t, ni)) {
+            if (t < minT) {
+                minT = t;
+                n = ni;
+                hitIdx = i;
+                hitType = 0;
+            }
+        }
+    }
+
+    // Trouver l'intersection la plus proche avec les murs
+    if (bvhNodeCount == 0) for (int i = 0; i < blockCount; ++i) {
+        float t;
+        vec3 ni;
+        vec3 halfSize = blockSize(i) * 0.5;
+        vec3 blockMin = blockCenter(i) - halfSize;
+        vec3 blockMax = blockCenter(i) + halfSize;
+
+        if (intersectBox(ro, rd, blockMin, blockMax, t, ni)) {
+            if (t < minT) {
+                minT = t;
+                n = ni;
+                hitIdx = i;
+                hitType = 1;
+            }
+        }
+    }
+
+    // Puis avec les triangles
+    if (bvhNodeCount == 0) for (int i = 0; i < triangleCount; ++i) {
+        float t;
+        vec3 ni;
+        if (intersectTriangleAt(ro, rd, i, t, ni) && t < minT) {
+            minT = t;
+            n = ni;
+            hitIdx = i;
+            hitType = 2;
+        }
+    }
+}
+
+// Matériau au point d'impact, avec le motif émissif animé des murs
+Material surfaceMaterial(vec3 hit, int hitIdx, int hitType) {
+    if (hitType == 2) return triangleMaterial(hitIdx);
+    if (hitType != 1) return sphereMaterial(hitIdx);
+
+    vec3 halfSize = blockSize(hitIdx) * 0.5;
+    vec3 blockMin = blockCenter(hitIdx) - halfSize;
+    vec3 blockMax = blockCenter(hitIdx) + halfSize;
+
+    Material matBase = blockMaterial(hitIdx);
+    float emissionFactor = emissionPattern(hit, blockMin, blockMax, time);
+    if (emissionFactor > 0.0) {
+        matBase.type = MAT_EMISSIVE;
+        matBase.albedo = vec3(1.0);  // ou couleur désirée
+    }
+    return matBase;
+}
+
 vec3 trace(vec3 ro, vec3 rd, float seed) {
     vec3 col = vec3(0.0);
     vec3 throughput = vec3(1.0);
@@ -457,42 +834,12 @@ vec3 trace(vec3 ro, vec3 rd, float seed) {
     for (int bounce = 0; bounce < MAX_BOUNCES; ++bounce) {
         float minT = 1e9;
         int hitIdx = -1;
-        int hitType = 0; // 0 = sphère, 1 = mur
-        vec3 n, hit;
+        int hitType = 0; // 0 = sphère, 1 = mur, 2 = triangle
+        vec3 n = vec3(0.0), hit;
         
         // Trouver l'intersection la plus proche
-        for (int i = 0; i < sphereCount; ++i) {
-            float t;
-            vec3 ni;
-            if (intersectSphere(ro, rd, spheres[i], t, ni)) {
-                if (t < minT) {
-                    minT = t;
-                    hit = ro + rd * t;
-                    n = ni;
-                    hitIdx = i;
-                    hitType = 0;
-                }
-            }
-        }
-
-        // Trouver l'intersection la plus proche avec les murs
-        for (int i = 0; i < blockCount; ++i) {
-            float t;
-            vec3 ni;
-            vec3 halfSize = blockSizes[i] * 0.5;
-            vec3 blockMin = blocks[i] - halfSize;
-            vec3 blockMax = blocks[i] + halfSize;
-
-            if (intersectBox(ro, rd, blockMin, blockMax, t, ni)) {
-                if (t < minT) {
-                    minT = t;
-                    hit = ro + rd * t;
-                    n = ni;
-                    hitIdx = i;
-                    hitType = 1;
-                }
-            }
-        }
+        intersectClosest(ro, rd, minT, n, hitIdx, hitType);
+        hit = ro + rd * minT;
 
         // Si pas d'intersection, ajouter un fond dégradé et sortir
         if (hitIdx == -1) {
@@ -504,24 +851,8 @@ vec3 trace(vec3 ro, vec3 rd, float seed) {
         }
 
         // Après avoir trouvé l'intersection:
-        Material mat;
-        if (hitType == 1) {
-    vec3 halfSize = blockSizes[hitIdx] * 0.5;
-    vec3 blockMin = blocks[hitIdx] - halfSize;
-    vec3 blockMax = blocks[hitIdx] + halfSize;
-
-    Material matBase = materials_block[hitIdx];
-    float emissionFactor = emissionPattern(hit, blockMin, blockMax, time);
-    if (emissionFactor > 0.0) {
-        matBase.type = MAT_EMISSIVE;
-        matBase.albedo = vec3(1.0);  // ou couleur désirée
-    }
-    mat = matBase;
-} else {
-    mat = materials[hitIdx];
-}
+        Material mat = surfaceMaterial(hit, hitIdx, hitType);
 
-        
         // Si on touche une source émissive, ajouter sa contribution et terminer
         if (mat.type == MAT_EMISSIVE) {
             col += throughput * mat.albedo * lightIntensity;
@@ -529,11 +860,11 @@ vec3 trace(vec3 ro, vec3 rd, float seed) {
         }
         
         // Ajout de l'échantillonnage direct de la lumière (NEE)
-        vec3 directLight = sampleDirectLight(hit, n, -rd, mat, seed + float(bounce) * 1.618);
+        vec3 directLight = sampleDirectLight(hit, n, -rd, mat, seed + float(bounce) * 1.618, bounce);
         col += throughput * directLight;
         
         //// Récupérer les propriétés du matériau
-        //Material mat = materials[hitIdx];
+        //Material mat = sphereMaterial(hitIdx);
         
         // Calculer l'éclairage direct
         //vec3 direct = directLight(hit, n, -rd, mat.type, mat.albedo, mat.roughness, minT);
@@ -542,13 +873,13 @@ vec3 trace(vec3 ro, vec3 rd, float seed) {
         // Calculer le prochain rayon en fonction du matériau
         if (mat.type == MAT_DIFFUSE) {
             // Surface diffuse: échantillonnage de l'hémisphère
-            rd = sampleHemisphere(n, hit, seed + float(bounce) * 3.14159);
+            rd = sampleHemisphere(n, hit, seed + float(bounce) * 3.14159, samplerBounceDim(bounce, SAMPLER_DIM_SCATTER));
             ro = hit + n * 0.001;
             throughput *= mat.albedo;
         }
         else if (mat.type == MAT_METALLIC) {
             // Surface métallique: réflexion
-            rd = reflect_custom(rd, n, mat.roughness, hit, seed + float(bounce) * 2.71828);
+            rd = reflect_custom(rd, n, mat.roughness, hit, seed + float(bounce) * 2.71828, samplerBounceDim(bounce, SAMPLER_DIM_SCATTER));
             ro = hit + n * 0.001;
             throughput *= mat.albedo;
         }
@@ -557,8 +888,8 @@ vec3 trace(vec3 ro, vec3 rd, float seed) {
             vec3 emitCol = mat.albedo;
 
             if (hitType == 1) { // mur
-                vec3 blockMin = blocks[hitIdx] - 0.5 * blockSizes[hitIdx];
-                vec3 blockMax = blocks[hitIdx] + 0.5 * blockSizes[hitIdx];
+                vec3 blockMin = blockCenter(hitIdx) - 0.5 * blockSize(hitIdx);
+                vec3 blockMax = blockCenter(hitIdx) + 0.5 * blockSize(hitIdx);
                 float strength = emissionPattern(hit, blockMin, blockMax, time);
                 emitCol *= strength;
             }
@@ -571,7 +902,7 @@ vec3 trace(vec3 ro, vec3 rd, float seed) {
         else if (mat.type == MAT_GLASS) {
             // Verre: réfraction ou réflexion
             float reflChance;
-            rd = refract(rd, n, mat.ior, mat.roughness, hit, seed + float(bounce) * 1.41421, reflChance);
+            rd = refract(rd, n, mat.ior, mat.roughness, hit, seed + float(bounce) * 1.41421, bounce, reflChance);
             ro = hit + normalize(rd) * 0.001;
             
             // Le verre absorbe un peu de lumière, principalement sur les longues distances
@@ -583,7 +914,7 @@ vec3 trace(vec3 ro, vec3 rd, float seed) {
         }
         else if (mat.type == MAT_MIRROR) {
             // Miroir: réflexion
-            rd = reflect_custom(rd, n, mat.roughness, hit, seed + float(bounce) * 1.73205);
+            rd = reflect_custom(rd, n, mat.roughness, hit, seed + float(bounce) * 1.73205, samplerBounceDim(bounce, SAMPLER_DIM_SCATTER));
             ro = hit + n * 0.001;
             throughput *= mat.albedo;
         }
@@ -594,7 +925,7 @@ vec3 trace(vec3 ro, vec3 rd, float seed) {
         if (bounce > 2) {
             float p = max(throughput.r, max(throughput.g, throughput.b));
             p = clamp(p, 0.0, 1.0);  // Ensure p stays in valid probability range
-            if (random(hit, seed + bounce * 0.77) > p) break;
+            if (sample1D(samplerBounceDim(bounce, SAMPLER_DIM_ROULETTE), hit, seed + bounce * 0.77) > p) break;
             throughput /= p;
         }
     }
@@ -610,24 +941,114 @@ mat3 setCamera(vec3 ro, vec3 ta) {
     return mat3(cu, cv, cw);
 }
 
+// Vecteur de mouvement d'un point vu dans la direction rd (distance t, 0 = ciel à
+// l'infini) : projection dans la caméra précédente, inverse de uv -> rd de main().
+// Mesuré depuis le point visé (pixel + cameraJitter) : le jitter n'est pas du mouvement
+vec4 motionVector(vec3 rd, float t) {
+    mat3 prevCam = setCamera(prevViewEye, prevViewCenter);
+    // prevCam est orthonormée : la transposée ramène dans son repère
+    vec3 local = (t > 0.0) ? (viewEye + rd * t - prevViewEye) * prevCam : rd * prevCam;
+    if (local.z <= 1e-4) return vec4(0.0);
+
+    vec2 prevUv = local.xy / local.z * 1.5;
+    vec2 prevFragCoord = (prevUv * resolution.y + resolution.xy) * 0.5;
+    return vec4((gl_FragCoord.xy + cameraJitter - prevFragCoord) / resolution.xy, (t > 0.0) ? local.z : 0.0, 1.0);
+}
+
+// G-buffer : premier impact du rayon passant par le centre du pixel décalé de
+// cameraJitter (sans jitter par échantillon), au même point que la couleur
+void writeGBuffer(mat3 cam) {
+    vec2 uv = ((gl_FragCoord.xy + cameraJitter) * 2.0 - resolution.xy) / resolution.y;
+    vec3 rd = cam * normalize(vec3(uv, 1.5));
+
+    float minT = 1e9;
+    int hitIdx = -1;
+    int hitType = 0;
+    vec3 n = vec3(0.0);
+    intersectClosest(viewEye, rd, minT, n, hitIdx, hitType);
+    if (hitIdx == -1) {
+        gNormalDepth = vec4(0.0);
+        gAlbedoMaterial = vec4(0.0, 0.0, 0.0, -1.0);
+        gMotion = motionVector(rd, 0.0);
+        return;
+    }
+
+    Material mat = surfaceMaterial(viewEye + rd * minT, hitIdx, hitType);
+    gNormalDepth = vec4(n, minT * dot(rd, cam[2]));
+    gAlbedoMaterial = vec4(mat.albedo, float(mat.type));
+    gMotion = motionVector(rd, minT);
+}
+
+// Budget du pixel en mode adaptatif : samplesPerPixel en moyenne, réparti proportionnellement
+// à l'écart type mesuré sur la frame précédente plus une part uniforme (renderCpuAdaptive) ;
+// le facteur d'échelle tient compte du plafond (sample_budget_reduce.fs)
+float pixelBudget() {
+    if (useSampleBudget == 0) return samplesPerPixel;
+    vec4 state = texelFetch(sampleBudgetState, ivec2(0), 0);
+    float deviation = texelFetch(sampleBudget, ivec2(gl_FragCoord.xy), 0).r;
+    // Première frame ou image uniforme : pas d'information, répartition égale
+    if (!(state.g > 1e-6) || isnan(deviation) || isinf(deviation)) return samplesPerPixel;
+    return min(state.r * (deviation + ADAPTIVE_UNIFORM_WEIGHT * state.g), float(ADAPTIVE_MAX_SAMPLES));
+}
+
+// Échantillons du pixel pour cette frame : partie entière du budget, plus un pour une
+// fraction m/4 des pixels de chaque bloc 2x2, choisis dans l'ordre de Bayer (0.5 = damier)
+// et décalés de m à chaque frame pour que tous les pixels y passent
+int pixelSampleCount(float budget) {
+    float base = floor(budget);
+    int extra = int((budget - base) * 4.0 + 0.5);
+    ivec2 cell = ivec2(gl_FragCoord.xy) & 1;
+    int bayer = (cell.x == cell.y) ? cell.x : 2 + cell.y;   // (0,0) 0, (1,1) 1, (0,1) 2, (1,0) 3
+    int rank = (bayer - frameIndex * extra) & 3;
+    return int(base) + (rank < extra ? 1 : 0);
+}
+
 void main() {
     vec3 color = vec3(0.0);
+    writeGBuffer(setCamera(viewEye, viewCenter));
     
-    // Anti-aliasing: multiplier les échantillons par pixel
+    // Anti-aliasing : plusieurs échantillons par pixel (pixelJitter), sinon temporel
     float sqrtSamples = sqrt(float(MAX_SAMPLES));
     float strataSize = 1.0 / sqrtSamples;
 
-    for (int s = 0; s < MAX_SAMPLES; ++s) {
-        // Calculer le décalage du sous-pixel pour l'anti-aliasing
-        int strataX = s % int(sqrt(float(MAX_SAMPLES)));
-        int strataY = s / int(sqrt(float(MAX_SAMPLES)));
+    // Échantillonnage adaptatif : budget du pixel d'après la frame précédente (pixelBudget),
+    // moyenne et variance de la luminance mises à jour à chaque échantillon (Welford), arrêt
+    // dès que l'écart type de la moyenne passe sous le seuil
+    float budget = adaptiveThreshold > 0.0 ? pixelBudget() : samplesPerPixel;
+    int sampleLimit = min(pixelSampleCount(budget), ADAPTIVE_MAX_SAMPLES);
+    if (sampleLimit == 0) {
+        // Pas d'échantillon cette frame : alpha 0, le débruiteur, l'accumulation et le TAA
+        // complètent avec les voisins ou l'historique
+        finalColor = vec4(0.0);
+        return;
+    }
+    int sampleCount = 0;
+    float lumMean = 0.0;
+    float lumM2 = 0.0;
+
+    for (int s = 0; s < ADAPTIVE_MAX_SAMPLES; ++s) {
+        if (s >= sampleLimit) break;
+
+        // Calculer le décalage du sous-pixel pour l'anti-aliasing (strates reprises au-delà de MAX_SAMPLES)
+        int strataIndex = s % MAX_SAMPLES;
+        int strataX = strataIndex % int(sqrt(float(MAX_SAMPLES)));
+        int strataY = strataIndex / int(sqrt(float(MAX_SAMPLES)));
 
-        vec2 strata = vec2(float(strataX), float(strataY)) * strataSize;
-        vec2 inStrata = vec2(random(vec3(gl_FragCoord.xy, time), float(s) * 0.1), random(vec3(gl_FragCoord.xy, time), float(s) * 0.2));
+        initPathSampler(ivec2(gl_FragCoord.xy), s);
 
-        vec2 jitter = strata + inStrata * strataSize - 0.5;
+        vec2 jitter = vec2(0.0);
+        if (pixelJitter == 0) {
+            // Un seul point par frame : la position change d'une frame à l'autre (cameraJitter)
+        } else if (samplerType == SAMPLER_HASH) {
+            vec2 strata = vec2(float(strataX), float(strataY)) * strataSize;
+            vec2 inStrata = vec2(random(vec3(gl_FragCoord.xy, time), float(s) * 0.1), random(vec3(gl_FragCoord.xy, time), float(s) * 0.2));
+            jitter = strata + inStrata * strataSize - 0.5;
+        } else {
+            // La suite est déjà stratifiée dans le pixel pour tout nombre d'échantillons
+            jitter = sampleLowDiscrepancy(SAMPLER_DIM_CAMERA) - 0.5;
+        }
         
-        vec2 uv = ((gl_FragCoord.xy + jitter) * 2.0 - resolution.xy) / resolution.y;
+        vec2 uv = ((gl_FragCoord.xy + cameraJitter + jitter) * 2.0 - resolution.xy) / resolution.y;
         
         // Mise en place de la caméra
         mat3 cam = setCamera(viewEye, viewCenter);
@@ -638,27 +1059,28 @@ void main() {
         float seed = float(s) + random(vec3(gl_FragCoord.xy, 0.0), time);
         
         // Tracer le rayon
-        color += trace(ro, rd, seed);
+        vec3 sampleColor = trace(ro, rd, seed);
+        color += sampleColor;
+        sampleCount++;
+
+        if (adaptiveThreshold > 0.0) {
+            float lum = dot(sampleColor, vec3(0.2126, 0.7152, 0.0722));
+            float delta = lum - lumMean;
+            lumMean += delta / float(sampleCount);
+            lumM2 += delta * (lum - lumMean);
+
+            if (sampleCount >= ADAPTIVE_MIN_SAMPLES) {
+                // Écart type ramené dans l'espace tone mappé x / (1 + x), comme le traceur CPU
+                float deviation = sqrt(lumM2 / float(sampleCount - 1)) / ((1.0 + lumMean) * (1.0 + lumMean));
+                if (deviation / sqrt(float(sampleCount)) <= adaptiveThreshold) break;
+            }
+        }
     }
     
     // Moyenne des échantillons
-    color /= float(MAX_SAMPLES);
-    
-    // Tone mapping (ACES)
-    const float a = 2.51;
-    const float b = 0.03;
-    const float c = 2.43;
-    const float d = 0.59;
-    const float e = 0.14;
-    color = clamp((color * (a * color + b)) / (color * (c * color + d) + e), 0.0, 1.0);
-    
-    // Correction gamma
-    color = pow(color, vec3(1.0 / 2.2));
-    
-    // Légère vignette
-    vec2 q = gl_FragCoord.xy / resolution.xy;
-    color *= 0.7 + 0.3 * pow(16.0 * q.x * q.y * (1.0 - q.x) * (1.0 - q.y), 0.1);
-    vec3 prevColor = texture(previousFrame, gl_FragCoord.xy / resolution.xy).rgb;
-    color = mix(color, prevColor, frameBlend);
+    color /= float(sampleCount);
+    
+    // Radiance linéaire (cible RGBA16F) : tone mapping, gamma et vignette dans tonemap.fs,
+    // après le débruitage et le TAA. Alpha 1 : pixel échantillonné cette frame
     finalColor = vec4(color, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "render_pool.h"
+#include "gbuffer.h"
+#include "rlgl.h"
+
+static const char *formatNames[] = { "RGBA8", "RGBA16F", "RGBA32F", "ext" };
+
+static RenderTexture2D loadPooledTarget(RenderTargetFormat format, int filter, int width, int height) {
+    RenderTexture2D target = { 0 };
+    if (format == RENDER_TARGET_RGBA8) target = LoadRenderTexture(width, height);
+    else if (format == RENDER_TARGET_RGBA16F) target = loadFloatRenderTexture(width, height, PIXELFORMAT_UNCOMPRESSED_R16G16B16A16);
+    else if (format == RENDER_TARGET_RGBA32F) target = loadFloatRenderTexture(width, height, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32);
+    if (target.id == 0) return target;
+
+    SetTextureFilter(target.texture, filter);
+    BeginTextureMode(target);
+        ClearBackground(BLACK);
+    EndTextureMode();
+    return target;
+}
+
+void initRenderPool(RenderPool *pool, int width, int height) {
+    pool->width = width;
+    pool->height = height;
+    pool->count = 0;
+    pool->reallocations = 0;
+}
+
+void unloadRenderPool(RenderPool *pool) {
+    for (int i = 0; i < pool->count; i++) {
+        if (pool->targets[i].target.id != 0) UnloadRenderTexture(pool->targets[i].target);
+        pool->targets[i].target = (RenderTexture2D){ 0 };
+    }
+    pool->count = 0;
+}
+
+int addRenderTarget(RenderPool *pool, const char *name, RenderTargetFormat format, int filter) {
+    if (pool->count >= RENDER_POOL_MAX_TARGETS || format == RENDER_TARGET_EXTERNAL) return -1;
+
+    PooledRenderTarget *entry = &pool->targets[pool->count];
+    entry->name = name;
+    entry->format = format;
+    entry->filter = filter;
+    // LoadRenderTexture ajoute un tampon de profondeur 24 bits (compté 4 octets)
+    entry->bytesPerPixel = (format == RENDER_TARGET_RGBA8) ? 4 + 4 : (format == RENDER_TARGET_RGBA32F) ? 16 : 8;
+    entry->target = loadPooledTarget(format, filter, pool->width, pool->height);
+    if (entry->target.id == 0) {
+        TraceLog(LOG_ERROR, "RENDERPOOL: cible %s %dx%d impossible", name, pool->width, pool->height);
+        return -1;
+    }
+    return pool->count++;
+}
+
+int addExternalRenderTarget(RenderPool *pool, const char *name, int bytesPerPixel) {
+    if (pool->count >= RENDER_POOL_MAX_TARGETS) return -1;
+
+    PooledRenderTarget *entry = &pool->targets[pool->count];
+    entry->name = name;
+    entry->format = RENDER_TARGET_EXTERNAL;
+    entry->filter = TEXTURE_FILTER_POINT;
+    entry->bytesPerPixel = bytesPerPixel;
+    entry->target = (RenderTexture2D){ 0 };
+    return pool->count++;
+}
+
+RenderTexture2D getRenderTarget(const RenderPool *pool, int index) {
+    return pool->targets[index].target;
+}
+
+int resizeRenderPool(RenderPool *pool, int width, int height) {
+    if (width < 1) width = 1;
+    if (height < 1) height = 1;
+    if (width == pool->width && height == pool->height) return 0;
+
+    // Libérer avant d'allouer : le pic mémoire reste celui d'un seul jeu de cibles
+    for (int i = 0; i < pool->count; i++) {
+        PooledRenderTarget *entry = &pool->targets[i];
+        if (entry->target.id != 0) UnloadRenderTexture(entry->target);
+        entry->target = (RenderTexture2D){ 0 };
+    }
+    pool->width = width;
+    pool->height = height;
+    pool->reallocations++;
+    for (int i = 0; i < pool->count; i++) {
+        PooledRenderTarget *entry = &pool->targets[i];
+        if (entry->format == RENDER_TARGET_EXTERNAL) continue;
+        entry->target = loadPooledTarget(entry->format, entry->filter, width, height);
+        if (entry->target.id == 0) {
+            TraceLog(LOG_ERROR, "RENDERPOOL: cible %s %dx%d impossible", entry->name, width, height);
+            return -1;
+        }
+    }
+    TraceLog(LOG_INFO, "RENDERPOOL: %dx%d, %.1f Mo", width, height, renderPoolBytes(pool) / (1024.0 * 1024.0));
+    return 1;
+}
+
+size_t renderTargetBytes(const RenderPool *pool, int index) {
+    return (size_t)pool->width * pool->height * pool->targets[index].bytesPerPixel;
+}
+
+size_t renderPoolBytes(const RenderPool *pool) {
+    size_t total = 0;
+    for (int i = 0; i < pool->count; i++) total += renderTargetBytes(pool, i);
+    return total;
+}
+
+void drawRenderPoolOverlay(const RenderPool *pool, int x, int y) {
+    const int lineHeight = 20;
+    DrawText(TextFormat("Render targets %dx%d", pool->width, pool->height), x, y, 20, WHITE);
+    for (int i = 0; i < pool->count; i++) {
+        const PooledRenderTarget *entry = &pool->targets[i];
+        y += lineHeight;
+        DrawText(entry->name, x, y, 20, WHITE);
+        DrawText(formatNames[entry->format], x + 170, y, 20, GRAY);
+        DrawText(TextFormat("%6.1f Mo", renderTargetBytes(pool, i) / (1024.0 * 1024.0)), x + 270, y, 20, WHITE);
+    }
+    y += lineHeight;
+    DrawText(TextFormat("total %.1f Mo, reallocations %d", renderPoolBytes(pool) / (1024.0 * 1024.0), pool->reallocations),
+             x, y, 20, WHITE);
+}
+
+void logRenderPool(const RenderPool *pool) {
+    for (int i = 0; i < pool->count; i++) {
+        const PooledRenderTarget *entry = &pool->targets[i];
+        TraceLog(LOG_INFO, "RENDERPOOL: %-16s %-7s %dx%d %.1f Mo", entry->name, formatNames[entry->format],
+                 pool->width, pool->height, renderTargetBytes(pool, i) / (1024.0 * 1024.0));
+    }
+    TraceLog(LOG_INFO, "RENDERPOOL: total %.1f Mo", renderPoolBytes(pool) / (1024.0 * 1024.0));
+}
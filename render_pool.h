@@ -0,0 +1,61 @@
+#ifndef RENDER_POOL_H
+#define RENDER_POOL_H
+
+#include "raylib.h"
+#include <stddef.h>
+
+// Cibles de rendu plein écran à la résolution interne (fenêtre x échelle de rendu).
+// Les utilisateurs gardent un indice et relisent la cible à chaque frame : un
+// changement de taille réalloue tout le pool, les cibles gardent leur indice.
+// Une cible (ré)allouée est effacée à (0, 0, 0, 1) : alpha 1 = historique rejeté
+// pour reproject.fs et taa.fs.
+// Les cibles à plusieurs attachements (GBuffer) sont réallouées par leur
+// propriétaire ; elles sont seulement déclarées pour le décompte mémoire.
+
+#define RENDER_POOL_MAX_TARGETS 16
+
+typedef enum {
+    RENDER_TARGET_RGBA8 = 0,
+    RENDER_TARGET_RGBA16F,
+    RENDER_TARGET_RGBA32F,      // accumulation longue (moyenne de milliers de frames)
+    RENDER_TARGET_EXTERNAL      // allouée ailleurs, bytesPerPixel donné à la déclaration
+} RenderTargetFormat;
+
+typedef struct {
+    const char *name;
+    RenderTargetFormat format;
+    int filter;                 // TEXTURE_FILTER_POINT ou TEXTURE_FILTER_BILINEAR
+    int bytesPerPixel;
+    RenderTexture2D target;     // id 0 pour RENDER_TARGET_EXTERNAL
+} PooledRenderTarget;
+
+typedef struct {
+    int width, height;          // résolution interne courante
+    int count;
+    PooledRenderTarget targets[RENDER_POOL_MAX_TARGETS];
+    int reallocations;          // nombre de changements de taille depuis le chargement
+} RenderPool;
+
+void initRenderPool(RenderPool *pool, int width, int height);
+void unloadRenderPool(RenderPool *pool);
+
+// Ajoute une cible allouée à la taille courante, retourne son indice (-1 en cas d'échec)
+int addRenderTarget(RenderPool *pool, const char *name, RenderTargetFormat format, int filter);
+// Déclare une cible gérée ailleurs pour le décompte mémoire
+int addExternalRenderTarget(RenderPool *pool, const char *name, int bytesPerPixel);
+
+RenderTexture2D getRenderTarget(const RenderPool *pool, int index);
+
+// Réalloue toutes les cibles si la taille change : retourne 1 si c'est le cas (les cibles
+// externes sont alors à réallouer par l'appelant), 0 si la taille est inchangée, -1 si une
+// allocation échoue (les anciennes cibles sont déjà libérées : le pool est inutilisable)
+int resizeRenderPool(RenderPool *pool, int width, int height);
+
+size_t renderTargetBytes(const RenderPool *pool, int index);
+size_t renderPoolBytes(const RenderPool *pool);
+
+// Liste des cibles avec leur taille mémoire ; TraceLog pour la version texte
+void drawRenderPoolOverlay(const RenderPool *pool, int x, int y);
+void logRenderPool(const RenderPool *pool);
+
+#endif // RENDER_POOL_H
@@ -0,0 +1,44 @@
+#version 330 core
+
+in vec2 fragTexCoord;
+out vec4 fragColor;
+
+// Reprojection de l'historique vers la frame courante avec les vecteurs de mouvement
+// du G-buffer. Sortie : historique rééchantillonné, alpha = taux de mélange du TAA,
+// ou 1 quand le pixel est découvert (l'historique doit alors être ignoré).
+// Exécuté à la résolution de la fenêtre, le G-buffer (résolution interne) est lu en uv.
+uniform sampler2D historyFrame;      // renderHistory (filtrage bilinéaire)
+uniform sampler2D motionVectors;     // uv - uv précédent, profondeur précédente attendue, validité
+uniform sampler2D normalDepth;       // G-buffer courant
+uniform sampler2D prevNormalDepth;   // G-buffer de la frame précédente
+uniform int skipGeometryTest;        // 1 : G-buffer réalloué (résolution interne changée), prevNormalDepth indéfini
+
+const float depthTolerance = 0.1;    // écart de profondeur relatif accepté
+const float normalTolerance = 0.9;   // cosinus minimal entre les normales
+
+void main() {
+    vec2 uv = fragTexCoord;
+    vec4 motion = texture(motionVectors, uv);
+    vec2 prevUv = uv - motion.xy;
+
+    bool valid = motion.w > 0.5 && all(greaterThanEqual(prevUv, vec2(0.0))) && all(lessThanEqual(prevUv, vec2(1.0)));
+    if (valid && skipGeometryTest == 0) {
+        vec4 prev = texture(prevNormalDepth, prevUv);
+        if (motion.z <= 0.0) {
+            // Ciel : reste du ciel
+            valid = prev.w <= 0.0;
+        } else {
+            vec3 n = texture(normalDepth, uv).xyz;
+            valid = prev.w > 0.0
+                 && abs(prev.w - motion.z) <= depthTolerance * motion.z
+                 && dot(n, prev.xyz) >= normalTolerance;
+        }
+    }
+
+    if (!valid) {
+        fragColor = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+    vec4 history = texture(historyFrame, prevUv);
+    fragColor = vec4(history.rgb, min(history.a, 0.5));
+}
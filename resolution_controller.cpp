@@ -0,0 +1,66 @@
+#include "resolution_controller.h"
+#include <math.h>
+
+// Au-dessus de targetMs * OVER_BUDGET on descend ; on ne remonte que si le palier
+// suivant est estimé sous targetMs * UNDER_BUDGET (hystérésis contre les oscillations)
+#define OVER_BUDGET 1.05f
+#define UNDER_BUDGET 0.9f
+#define FILTER_RATE 0.1f
+
+void initResolutionController(ResolutionController *controller, float targetMs, float minScale, float maxScale,
+                              float step) {
+    controller->enabled = true;
+    controller->targetMs = targetMs;
+    controller->minScale = minScale;
+    controller->maxScale = maxScale;
+    controller->step = step;
+    controller->level = 0;
+    controller->levelCount = (int)floorf((maxScale - minScale) / step + 0.5f) + 1;
+    if (controller->levelCount < 1) controller->levelCount = 1;
+    controller->filteredMs = -1.0f;
+    controller->cooldown = 0;
+    controller->changes = 0;
+}
+
+static float levelScale(const ResolutionController *controller, int level) {
+    float scale = controller->maxScale - level * controller->step;
+    return (scale < controller->minScale) ? controller->minScale : scale;
+}
+
+float resolutionControllerScale(const ResolutionController *controller) {
+    return controller->enabled ? levelScale(controller, controller->level) : controller->maxScale;
+}
+
+bool updateResolutionController(ResolutionController *controller, float frameMs) {
+    if (!controller->enabled || frameMs < 0.0f) return false;
+
+    if (controller->filteredMs < 0.0f) controller->filteredMs = frameMs;
+    else controller->filteredMs += (frameMs - controller->filteredMs) * FILTER_RATE;
+    if (controller->cooldown > 0) {
+        controller->cooldown--;
+        return false;
+    }
+
+    // Le coût du traçage suit le nombre de pixels, soit le carré de l'échelle
+    float scale = levelScale(controller, controller->level);
+    int level = controller->level;
+    if (controller->filteredMs > controller->targetMs * OVER_BUDGET) {
+        // Descente directe vers l'échelle estimée pour le budget, au moins un palier
+        float wanted = scale * sqrtf(controller->targetMs / controller->filteredMs);
+        int steps = (int)ceilf((scale - wanted) / controller->step);
+        level += (steps < 1) ? 1 : steps;
+        if (level > controller->levelCount - 1) level = controller->levelCount - 1;
+    } else if (level > 0) {
+        float next = levelScale(controller, level - 1);
+        float predictedMs = controller->filteredMs * (next * next) / (scale * scale);
+        if (predictedMs < controller->targetMs * UNDER_BUDGET) level--;
+    }
+    if (level == controller->level) return false;
+
+    float newScale = levelScale(controller, level);
+    controller->filteredMs *= (newScale * newScale) / (scale * scale);
+    controller->level = level;
+    controller->cooldown = RESOLUTION_CONTROLLER_COOLDOWN;
+    controller->changes++;
+    return true;
+}
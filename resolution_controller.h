@@ -0,0 +1,36 @@
+#ifndef RESOLUTION_CONTROLLER_H
+#define RESOLUTION_CONTROLLER_H
+
+// Résolution dynamique : ajuste l'échelle de la résolution interne (G-buffer,
+// débruitage, accumulation) pour tenir un budget de temps GPU par frame ; le TAA
+// et la présentation restent à la résolution de la fenêtre.
+// L'échelle est quantifiée par paliers (chaque changement réalloue les cibles
+// internes). Le temps mesuré est lissé, et après un changement le contrôleur
+// attend que les mesures de la nouvelle résolution arrivent (GPU_TIMER_LATENCY)
+// et se stabilisent avant de bouger à nouveau.
+
+#define RESOLUTION_CONTROLLER_COOLDOWN 30   // frames sans changement après un palier
+
+typedef struct {
+    bool enabled;
+    float targetMs;             // budget GPU par frame
+    float minScale, maxScale;   // bornes de l'échelle (fraction de la fenêtre)
+    float step;                 // écart entre deux paliers
+    int level;                  // 0 = maxScale, chaque niveau retire un palier
+    int levelCount;
+    float filteredMs;           // moyenne glissante du temps mesuré, -1 avant la première mesure
+    int cooldown;
+    int changes;                // nombre de changements de palier
+} ResolutionController;
+
+void initResolutionController(ResolutionController *controller, float targetMs, float minScale, float maxScale,
+                              float step);
+
+// frameMs : temps GPU de la dernière frame lue (GpuTimer::lastFrameMs), négatif si
+// indisponible ; retourne true si le palier a changé
+bool updateResolutionController(ResolutionController *controller, float frameMs);
+
+// Échelle du palier courant (maxScale si le contrôleur est désactivé)
+float resolutionControllerScale(const ResolutionController *controller);
+
+#endif // RESOLUTION_CONTROLLER_H
@@ -0,0 +1,127 @@
+#include "sample_budget.h"
+#include "gbuffer.h"
+#include "rlgl.h"
+
+static void unloadLevels(SampleBudget *budget) {
+    for (int i = 0; i < budget->levelCount; i++) UnloadRenderTexture(budget->levels[i]);
+    budget->levelCount = 0;
+    budget->levelsWidth = 0;
+    budget->levelsHeight = 0;
+}
+
+// Un niveau par passe tant que la sortie dépasse un bloc ; la dernière passe écrit l'état 1x1
+static bool loadLevels(SampleBudget *budget, int width, int height) {
+    unloadLevels(budget);
+    while (width > SAMPLE_BUDGET_BLOCK || height > SAMPLE_BUDGET_BLOCK) {
+        width = (width + SAMPLE_BUDGET_BLOCK - 1) / SAMPLE_BUDGET_BLOCK;
+        height = (height + SAMPLE_BUDGET_BLOCK - 1) / SAMPLE_BUDGET_BLOCK;
+        if (budget->levelCount == SAMPLE_BUDGET_MAX_LEVELS) return false;
+        RenderTexture2D level = loadFloatRenderTexture(width, height, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32);
+        if (level.id == 0) return false;
+        budget->levels[budget->levelCount++] = level;
+    }
+    return true;
+}
+
+bool loadSampleBudget(SampleBudget *budget, Shader shader, Shader reduceShader, RenderPool *pool, GpuTimer *timer) {
+    budget->shader = shader;
+    budget->reduceShader = reduceShader;
+    budget->sourceSizeLoc = GetShaderLocation(reduceShader, "sourceSize");
+    budget->firstLevelLoc = GetShaderLocation(reduceShader, "firstLevel");
+    budget->lastLevelLoc = GetShaderLocation(reduceShader, "lastLevel");
+    budget->redistributeLoc = GetShaderLocation(reduceShader, "redistribute");
+    budget->samplesPerPixelLoc = GetShaderLocation(reduceShader, "samplesPerPixel");
+    budget->pixelCountLoc = GetShaderLocation(reduceShader, "pixelCount");
+    budget->budgetStateLoc = GetShaderLocation(reduceShader, "budgetState");
+    budget->pass = addGpuPass(timer, "sample_budget");
+    budget->levelCount = 0;
+    budget->levelsWidth = 0;
+    budget->levelsHeight = 0;
+    budget->currentState = 0;
+
+    budget->target = addRenderTarget(pool, "sample_budget", RENDER_TARGET_RGBA16F, TEXTURE_FILTER_POINT);
+    budget->states[0] = loadFloatRenderTexture(1, 1, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32);
+    budget->states[1] = loadFloatRenderTexture(1, 1, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32);
+    return budget->target >= 0 && budget->states[0].id != 0 && budget->states[1].id != 0;
+}
+
+void unloadSampleBudget(SampleBudget *budget) {
+    unloadLevels(budget);
+    for (int i = 0; i < 2; i++) {
+        if (budget->states[i].id != 0) UnloadRenderTexture(budget->states[i]);
+        budget->states[i] = (RenderTexture2D){ 0 };
+    }
+}
+
+// Somme de la carte d'écarts types (redistribute 0) ou des contributions plafonnées selon
+// l'état courant (redistribute 1), niveau par niveau jusqu'au nouvel état
+static void reduceSampleBudget(SampleBudget *budget, Texture2D deviation, int redistribute) {
+    Texture2D previousState = budget->states[budget->currentState].texture;
+    RenderTexture2D nextState = budget->states[1 - budget->currentState];
+
+    Texture2D source = deviation;
+    for (int level = 0; level <= budget->levelCount; level++) {
+        RenderTexture2D output = (level < budget->levelCount) ? budget->levels[level] : nextState;
+        int sourceSize[2] = { source.width, source.height };
+        int firstLevel = (level == 0) ? 1 : 0;
+        int lastLevel = (level == budget->levelCount) ? 1 : 0;
+
+        // Sorties lues avec texelFetch depuis gl_FragCoord : l'orientation est indifférente
+        BeginTextureMode(output);
+            BeginShaderMode(budget->reduceShader);
+                SetShaderValue(budget->reduceShader, budget->sourceSizeLoc, sourceSize, SHADER_UNIFORM_IVEC2);
+                SetShaderValue(budget->reduceShader, budget->firstLevelLoc, &firstLevel, SHADER_UNIFORM_INT);
+                SetShaderValue(budget->reduceShader, budget->lastLevelLoc, &lastLevel, SHADER_UNIFORM_INT);
+                SetShaderValue(budget->reduceShader, budget->redistributeLoc, &redistribute, SHADER_UNIFORM_INT);
+                SetShaderValueTexture(budget->reduceShader, budget->budgetStateLoc, previousState);
+                DrawTexturePro(source, (Rectangle){ 0.0f, 0.0f, (float)source.width, (float)source.height },
+                               (Rectangle){ 0.0f, 0.0f, (float)output.texture.width, (float)output.texture.height },
+                               (Vector2){ 0.0f, 0.0f }, 0.0f, WHITE);
+            EndShaderMode();
+        EndTextureMode();
+        source = output.texture;
+    }
+    budget->currentState = 1 - budget->currentState;
+}
+
+bool updateSampleBudget(SampleBudget *budget, const RenderPool *pool, Texture2D previousFrame, float samplesPerPixel,
+                        GpuTimer *timer) {
+    if (budget->levelsWidth != pool->width || budget->levelsHeight != pool->height) {
+        if (!loadLevels(budget, pool->width, pool->height)) {
+            TraceLog(LOG_ERROR, "SAMPLE BUDGET: niveaux de réduction %dx%d impossibles", pool->width, pool->height);
+            unloadLevels(budget);
+            return false;
+        }
+        budget->levelsWidth = pool->width;
+        budget->levelsHeight = pool->height;
+    }
+    RenderTexture2D output = getRenderTarget(pool, budget->target);
+    float pixelCount = (float)pool->width * pool->height;
+
+    beginGpuPass(timer, budget->pass);
+    rlDisableColorBlend();
+    BeginTextureMode(output);
+        BeginShaderMode(budget->shader);
+            DrawTexturePro(previousFrame, (Rectangle){ 0.0f, 0.0f, (float)pool->width, -(float)pool->height },
+                           (Rectangle){ 0.0f, 0.0f, (float)pool->width, (float)pool->height }, (Vector2){ 0.0f, 0.0f },
+                           0.0f, WHITE);
+        EndShaderMode();
+    EndTextureMode();
+
+    // Moyenne des écarts types, puis excédent des pixels plafonnés rendu aux autres
+    SetShaderValue(budget->reduceShader, budget->samplesPerPixelLoc, &samplesPerPixel, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(budget->reduceShader, budget->pixelCountLoc, &pixelCount, SHADER_UNIFORM_FLOAT);
+    reduceSampleBudget(budget, output.texture, 0);
+    for (int i = 0; i < SAMPLE_BUDGET_ITERATIONS; i++) reduceSampleBudget(budget, output.texture, 1);
+    rlEnableColorBlend();
+    endGpuPass(timer);
+    return true;
+}
+
+Texture2D sampleBudgetDeviation(const SampleBudget *budget, const RenderPool *pool) {
+    return getRenderTarget(pool, budget->target).texture;
+}
+
+Texture2D sampleBudgetState(const SampleBudget *budget) {
+    return budget->states[budget->currentState].texture;
+}
@@ -0,0 +1,42 @@
+#version 330 core
+
+in vec2 fragTexCoord;
+out vec4 fragColor;
+
+// Écart type de la luminance tone mappée x / (1 + x) (unités du seuil adaptatif et de
+// renderCpuAdaptive) sur le voisinage 3x3 de la frame précédente, échantillons présents
+// seulement. Sortie dans r, sommée ensuite par sample_budget_reduce.fs (sample_budget.h)
+uniform sampler2D texture0;   // radiance de la frame précédente, alpha 0 = pas d'échantillon
+
+float toneMappedLuminance(vec3 c) {
+    float l = dot(c, vec3(0.2126, 0.7152, 0.0722));
+    // Cible réallouée (changement de résolution) : contenu indéfini jusqu'à la frame suivante
+    if (isnan(l) || isinf(l)) return 0.0;
+    l = max(l, 0.0);
+    return l / (1.0 + l);
+}
+
+void main() {
+    ivec2 size = textureSize(texture0, 0);
+    ivec2 pixel = ivec2(fragTexCoord * vec2(size));
+
+    float sum = 0.0;
+    float sum2 = 0.0;
+    float count = 0.0;
+    for (int j = -1; j <= 1; ++j) {
+        for (int i = -1; i <= 1; ++i) {
+            vec4 c = texelFetch(texture0, clamp(pixel + ivec2(i, j), ivec2(0), size - 1), 0);
+            if (!(c.a > 0.0)) continue;
+            float l = toneMappedLuminance(c.rgb);
+            sum += l;
+            sum2 += l * l;
+            count += 1.0;
+        }
+    }
+    float deviation = 0.0;
+    if (count > 1.0) {
+        float mean = sum / count;
+        deviation = sqrt(max(sum2 - count * mean * mean, 0.0) / (count - 1.0));
+    }
+    fragColor = vec4(deviation, 0.0, 0.0, 1.0);
+}
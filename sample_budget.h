@@ -0,0 +1,51 @@
+#ifndef SAMPLE_BUDGET_H
+#define SAMPLE_BUDGET_H
+
+#include "raylib.h"
+#include "gpu_timer.h"
+#include "render_pool.h"
+
+// Répartition du budget d'échantillons en mode adaptatif (comme renderCpuAdaptive) :
+// sample_budget.fs estime l'écart type de la luminance tone mappée de chaque pixel sur
+// le voisinage 3x3 de la frame précédente. raytest.fs attribue alors à chaque pixel
+//   min(scale * (sigma + ADAPTIVE_UNIFORM_WEIGHT * moyenne), ADAPTIVE_MAX_SAMPLES)
+// échantillons, avec scale choisi pour un total de samplesPerPixel * pixels (moins ce que
+// l'arrêt des pixels convergés économise).
+// scale et la moyenne sont calculés sur le GPU par sample_budget_reduce.fs : sommes exactes
+// par blocs de SAMPLE_BUDGET_BLOCK² jusqu'à une cible 1x1 (l'état), d'abord des écarts
+// types, puis SAMPLE_BUDGET_ITERATIONS fois des échantillons plafonnés et des poids libres
+// pour rendre aux autres pixels ce que le plafond retire.
+
+#define SAMPLE_BUDGET_BLOCK 8           // côté des blocs sommés par passe (BLOCK_SIZE du shader)
+#define SAMPLE_BUDGET_MAX_LEVELS 8      // niveaux intermédiaires de la réduction
+#define SAMPLE_BUDGET_ITERATIONS 3      // redistributions de l'excédent plafonné
+
+typedef struct {
+    Shader shader;
+    Shader reduceShader;
+    int sourceSizeLoc, firstLevelLoc, lastLevelLoc, redistributeLoc;
+    int samplesPerPixelLoc, pixelCountLoc, budgetStateLoc;
+    int target;         // cible du RenderPool : écart type dans r
+    int pass;           // passe GpuTimer
+    // Niveaux intermédiaires RGBA32F (1/64 des pixels au plus), alloués à la taille du pool
+    RenderTexture2D levels[SAMPLE_BUDGET_MAX_LEVELS];
+    int levelCount;
+    int levelsWidth, levelsHeight;
+    RenderTexture2D states[2];  // 1x1 RGBA32F alternées : scale (r), écart type moyen (g)
+    int currentState;
+} SampleBudget;
+
+bool loadSampleBudget(SampleBudget *budget, Shader shader, Shader reduceShader, RenderPool *pool, GpuTimer *timer);
+void unloadSampleBudget(SampleBudget *budget);
+
+// previousFrame : radiance de la frame précédente (G-buffer, alpha 0 = pas d'échantillon).
+// Retourne false si les niveaux de réduction n'ont pu être alloués (raytest.fs garde alors
+// samplesPerPixel partout)
+bool updateSampleBudget(SampleBudget *budget, const RenderPool *pool, Texture2D previousFrame, float samplesPerPixel,
+                        GpuTimer *timer);
+
+// Textures lues par raytest.fs, valides jusqu'au prochain appel à updateSampleBudget
+Texture2D sampleBudgetDeviation(const SampleBudget *budget, const RenderPool *pool);
+Texture2D sampleBudgetState(const SampleBudget *budget);
+
+#endif // SAMPLE_BUDGET_H
@@ -0,0 +1,61 @@
+#version 330 core
+
+out vec4 fragColor;
+
+#define ADAPTIVE_MAX_SAMPLES 16        // comme raytest.fs
+#define ADAPTIVE_UNIFORM_WEIGHT 0.5    // comme raytest.fs
+#define BLOCK_SIZE 8                   // SAMPLE_BUDGET_BLOCK (sample_budget.h)
+
+// Réduction du budget adaptatif (sample_budget.h) : chaque texel de sortie somme un bloc
+// BLOCK_SIZE x BLOCK_SIZE de la source, en float 32 bits. Au premier niveau, la source est
+// la carte d'écarts types et chaque pixel y apporte sa contribution ; au dernier niveau
+// (sortie 1x1), les sommes donnent l'état de la répartition :
+//   r : facteur d'échelle, budget d'un pixel = min(r * (sigma + ADAPTIVE_UNIFORM_WEIGHT * g), ADAPTIVE_MAX_SAMPLES)
+//   g : écart type moyen (0 : pas d'information, répartition égale)
+uniform sampler2D texture0;        // niveau précédent (sommes dans rg), ou écarts types (r)
+uniform sampler2D budgetState;     // état de l'étape précédente
+uniform ivec2 sourceSize;          // texels de texture0 à sommer
+uniform int firstLevel;            // texture0 = carte d'écarts types
+uniform int lastLevel;             // sortie 1x1 : écrit l'état
+uniform int redistribute;          // 0 : somme des écarts types ; 1 : échantillons plafonnés (r), poids libres (g)
+uniform float samplesPerPixel;     // budget moyen visé
+uniform float pixelCount;          // texels de la carte d'écarts types
+
+vec2 contribution(float deviation, vec4 state) {
+    if (redistribute == 0) return vec2(deviation, 0.0);
+    float weight = deviation + ADAPTIVE_UNIFORM_WEIGHT * state.g;
+    if (state.r * weight >= float(ADAPTIVE_MAX_SAMPLES)) return vec2(float(ADAPTIVE_MAX_SAMPLES), 0.0);
+    return vec2(0.0, weight);
+}
+
+void main() {
+    vec4 state = texelFetch(budgetState, ivec2(0), 0);
+    ivec2 origin = ivec2(gl_FragCoord.xy) * BLOCK_SIZE;
+
+    vec2 sum = vec2(0.0);
+    for (int j = 0; j < BLOCK_SIZE; ++j) {
+        for (int i = 0; i < BLOCK_SIZE; ++i) {
+            ivec2 texel = origin + ivec2(i, j);
+            if (texel.x >= sourceSize.x || texel.y >= sourceSize.y) continue;
+            vec4 value = texelFetch(texture0, texel, 0);
+            sum += (firstLevel != 0) ? contribution(value.r, state) : value.rg;
+        }
+    }
+    if (lastLevel == 0) {
+        fragColor = vec4(sum, 0.0, 1.0);
+        return;
+    }
+
+    if (redistribute == 0) {
+        // Répartition proportionnelle, samplesPerPixel par pixel en moyenne avant plafond
+        float mean = sum.x / pixelCount;
+        float scale = (mean > 1e-6) ? samplesPerPixel / ((1.0 + ADAPTIVE_UNIFORM_WEIGHT) * mean) : 0.0;
+        fragColor = vec4(scale, mean, 0.0, 1.0);
+    } else {
+        // Échantillons retirés par le plafond rendus aux pixels libres : le total revient à
+        // samplesPerPixel * pixelCount tant qu'aucun nouveau pixel n'atteint le plafond
+        float scale = state.r;
+        if (sum.y > 0.0) scale = max((samplesPerPixel * pixelCount - sum.x) / sum.y, state.r);
+        fragColor = vec4(scale, state.g, 0.0, 1.0);
+    }
+}
@@ -0,0 +1,126 @@
+#include "sampler.h"
+#include <math.h>
+#include <string.h>
+
+// Même hash que raytest.fs
+static inline uint32_t hash(uint32_t x) {
+    x = x * 1664525u + 1013904223u;
+    x ^= x >> 16u;
+    x *= 0x3dba2d8du;
+    x ^= x >> 16u;
+    return x;
+}
+
+static inline uint32_t reverseBits(uint32_t x) {
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0f0f0f0fu) | ((x & 0x0f0f0f0fu) << 4);
+    x = ((x >> 8) & 0x00ff00ffu) | ((x & 0x00ff00ffu) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+// Permutation de Laine-Karras : chaque bit ne dépend que des bits de poids plus faible
+static inline uint32_t laineKarrasPermutation(uint32_t x, uint32_t seed) {
+    x += seed;
+    x ^= x * 0x6c50b47cu;
+    x ^= x * 0xb82f1e52u;
+    x ^= x * 0xc7afe638u;
+    x ^= x * 0x8d22f6e6u;
+    return x;
+}
+
+// Brouillage d'Owen (permutation uniforme imbriquée) sur les bits de poids fort
+static inline uint32_t nestedUniformScramble(uint32_t x, uint32_t seed) {
+    return reverseBits(laineKarrasPermutation(reverseBits(x), seed));
+}
+
+// Deuxième dimension de Sobol (polynôme x + 1), la première est reverseBits(index)
+static inline uint32_t sobolSecond(uint32_t index) {
+    uint32_t result = 0;
+    uint32_t v = 0x80000000u;
+    for (; index != 0; index >>= 1) {
+        if (index & 1u) result ^= v;
+        v ^= v >> 1;
+    }
+    return result;
+}
+
+// 24 bits de poids fort -> [0,1), identique à la conversion du shader
+static inline float toUnitFloat(uint32_t x) {
+    return (float)(x >> 8) * (1.0f / 16777216.0f);
+}
+
+static inline float fractf(float x) {
+    return x - floorf(x);
+}
+
+// Suite R2 : inverses des puissances du nombre plastique
+#define R2_ALPHA_X 0.7548776662466927f
+#define R2_ALPHA_Y 0.5698402909980532f
+
+PathSampler makePathSampler(int type, int pixelX, int pixelY, float time, int index) {
+    PathSampler sampler;
+    sampler.type = type;
+    sampler.frameSeed = hash((uint32_t)(int64_t)(time * 91.237f));
+    sampler.pixelSeed = hash((uint32_t)pixelX ^ hash((uint32_t)pixelY ^ sampler.frameSeed));
+    sampler.index = (uint32_t)index;
+    // Masque R2 : pixels voisins décalés de quantités très différentes (bruit bleu approché)
+    sampler.pixelOffset.x = fractf((float)pixelX * R2_ALPHA_X + (float)pixelY * R2_ALPHA_Y);
+    sampler.pixelOffset.y = fractf((float)pixelX * R2_ALPHA_Y + (float)pixelY * R2_ALPHA_X);
+    return sampler;
+}
+
+Vector2 sampleLowDiscrepancy(const PathSampler *sampler, int dimension) {
+    uint32_t dimensionHash = hash((uint32_t)dimension + 1u);
+    Vector2 result;
+
+    if (sampler->type == SAMPLER_RANK1) {
+        // Décalage par dimension commun à tous les pixels : la structure du masque est conservée
+        uint32_t seed = sampler->frameSeed ^ dimensionHash;
+        float shiftX = toUnitFloat(hash(seed));
+        float shiftY = toUnitFloat(hash(seed ^ 0x9e3779b9u));
+        float index = (float)sampler->index;
+        result.x = fractf(sampler->pixelOffset.x + shiftX + index * R2_ALPHA_X);
+        result.y = fractf(sampler->pixelOffset.y + shiftY + index * R2_ALPHA_Y);
+        return result;
+    }
+
+    // Sobol-Owen : indice mélangé par dimension puis chaque composante brouillée
+    uint32_t seed = hash(sampler->pixelSeed ^ dimensionHash);
+    uint32_t shuffled = nestedUniformScramble(sampler->index, seed);
+    uint32_t x = nestedUniformScramble(reverseBits(shuffled), hash(seed ^ 0xa511e9b3u));
+    uint32_t y = nestedUniformScramble(sobolSecond(shuffled), hash(seed ^ 0x63d83595u));
+    result.x = toUnitFloat(x);
+    result.y = toUnitFloat(y);
+    return result;
+}
+
+static float radicalInverse(uint32_t index, uint32_t base) {
+    float inverseBase = 1.0f / (float)base;
+    float factor = inverseBase;
+    float result = 0.0f;
+    while (index > 0) {
+        result += (float)(index % base) * factor;
+        index /= base;
+        factor *= inverseBase;
+    }
+    return result;
+}
+
+Vector2 haltonJitter(int frameIndex) {
+    uint32_t index = (uint32_t)(frameIndex % HALTON_JITTER_PERIOD) + 1;
+    return (Vector2){ radicalInverse(index, 2) - 0.5f, radicalInverse(index, 3) - 0.5f };
+}
+
+static const char *samplerNames[SAMPLER_COUNT] = { "hash", "sobol", "rank1" };
+
+int findSamplerType(const char *name) {
+    for (int i = 0; i < SAMPLER_COUNT; i++) {
+        if (strcmp(name, samplerNames[i]) == 0) return i;
+    }
+    return -1;
+}
+
+const char *samplerTypeName(int type) {
+    return (type >= 0 && type < SAMPLER_COUNT) ? samplerNames[type] : "?";
+}
@@ -0,0 +1,69 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include "raylib.h"
+#include <stdint.h>
+
+// Échantillonneurs à faible discrépance partagés par le traceur CPU et raytest.fs
+// (les fonctions GLSL portent les mêmes noms). Chaque tirage aléatoire d'un chemin a
+// sa dimension (caméra, puis par rebond : direction, Fresnel, roulette, réfraction,
+// lumières) ; chaque dimension est une paire 2D décorrélée des autres.
+//   SAMPLER_HASH  : bruit blanc historique random(pos, seed) de raytest.fs
+//   SAMPLER_SOBOL : Sobol 2D avec brouillage d'Owen par hachage (Burley 2020), indice
+//                   mélangé par dimension pour décorréler les paires
+//   SAMPLER_RANK1 : réseau de rang 1 (suite R2) décalé par pixel avec un masque R2,
+//                   erreur répartie en bruit bleu à l'écran
+
+#define SAMPLER_HASH 0
+#define SAMPLER_SOBOL 1
+#define SAMPLER_RANK1 2
+#define SAMPLER_COUNT 3
+
+// Disposition des dimensions (identique dans raytest.fs)
+#define SAMPLER_DIM_CAMERA 0
+#define SAMPLER_DIM_BOUNCE 1        // première dimension du rebond 0
+#define SAMPLER_BOUNCE_DIMS 16      // dimensions réservées par rebond
+#define SAMPLER_DIM_SCATTER 0       // direction (hémisphère, réflexion)
+#define SAMPLER_DIM_FRESNEL 1       // choix réflexion / réfraction du verre
+#define SAMPLER_DIM_ROULETTE 2      // roulette russe
+#define SAMPLER_DIM_REFRACT 3       // perturbation de la réfraction rugueuse
+#define SAMPLER_DIM_LIGHT 4         // + rang de la sphère lumineuse parmi les émissives
+// Dimensions de lumière par rebond : au-delà, les lumières reprennent les mêmes dimensions
+// (rang modulo SAMPLER_LIGHT_DIMS) au lieu de déborder sur celles du rebond suivant.
+// Deux lumières qui partagent une dimension ont des tirages corrélés, chacune restant sans biais
+#define SAMPLER_LIGHT_DIMS (SAMPLER_BOUNCE_DIMS - SAMPLER_DIM_LIGHT)
+
+// État d'un échantillon de pixel
+typedef struct {
+    int type;
+    uint32_t frameSeed;   // dépend de time seulement (décalages du réseau de rang 1)
+    uint32_t pixelSeed;   // dépend du pixel et de time (brouillage d'Owen)
+    uint32_t index;       // numéro de l'échantillon dans le pixel
+    Vector2 pixelOffset;  // masque R2 du pixel
+} PathSampler;
+
+static inline int samplerBounceDim(int bounce, int dim) {
+    return SAMPLER_DIM_BOUNCE + bounce * SAMPLER_BOUNCE_DIMS + dim;
+}
+
+static inline int samplerLightDim(int bounce, int light) {
+    return samplerBounceDim(bounce, SAMPLER_DIM_LIGHT + light % SAMPLER_LIGHT_DIMS);
+}
+
+// pixelX, pixelY : coordonnées entières du pixel, origine en bas (comme gl_FragCoord)
+PathSampler makePathSampler(int type, int pixelX, int pixelY, float time, int index);
+
+// Point 2D dans [0,1)^2 pour Sobol et rang 1 (SAMPLER_HASH est géré par l'appelant)
+Vector2 sampleLowDiscrepancy(const PathSampler *sampler, int dimension);
+
+// Jitter de caméra par frame : point frameIndex de la suite de Halton (2, 3), centré
+// dans [-0.5, 0.5)^2 pixel. Cycle de HALTON_JITTER_PERIOD frames (l'indice 0, qui
+// vaut (0, 0), est sauté). Appliqué aux rayons de raytest.fs et retiré par taa.fs
+#define HALTON_JITTER_PERIOD 16
+Vector2 haltonJitter(int frameIndex);
+
+// "hash", "sobol", "rank1" -> type, -1 si inconnu
+int findSamplerType(const char *name);
+const char *samplerTypeName(int type);
+
+#endif // SAMPLER_H
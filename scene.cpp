@@ -0,0 +1,59 @@
+#include "scene.h"
+
+// Données des sphères
+Sphere spheres[MAX_SPHERES] = {
+    {{0.0f, 0.0f, 0.0f}, 1.0f},     // Sphère centrale
+    {{1.5f, 0.0f, 1.5f}, 0.5f}      // Petite sphère
+    //{{-2.5f, 0.0f, 0.0f}, 1.0f},    // Sphère à gauche
+    //{{2.5f, 0.0f, 0.0f}, 1.0f},     // Sphère à droite
+    //{{0.0f, -1001.0f, 0.0f}, 1000.0f}, // Sol (grosse sphère en dessous)
+    //{{0.0f, 0.0f, -2.5f}, 1.0f},    // Sphère derrière
+    //{{0.0f, 0.0f, 2.5f}, 1.0f},     // Sphère devant
+    //{{-1.5f, 0.0f, -1.5f}, 0.5f},   // Petite sphère
+};
+
+// Matériaux correspondants
+//int type;       // Type de matériau
+//float roughness; // Rugosité (métal, verre)
+//float ior;      // Indice de réfraction (verre)
+//float padding;  // Padding pour l'alignement
+//vec3 albedo;    // Couleur de base
+//float padding2; // Padding supplémentaire
+
+Material2 materials[MAX_SPHERES] = {
+    {4, 0.0f, 1.0f, 0.0f, {1.0f, 1.0f, 1.0f}, 0.0f},    // Balle miroir
+    {3, 0.0f, 1.0f, 0.0f, {0.9f, 0.9f, 0.0f}, 0.0f}     // Jaune diffus
+    //{1, 0.1f, 1.0f, 0.0f, {0.8f, 0.8f, 0.9f}, 0.0f},    // Métal bleuté
+    //{2, 0.0f, 1.5f, 0.0f, {0.9f, 0.9f, 0.9f}, 0.0f},    // Verre
+    //{0, 0.5f, 1.0f, 0.0f, {0.8f, 0.8f, 0.8f}, 0.0f},    // Sol gris diffus
+    //{0, 0.2f, 1.0f, 0.0f, {0.9f, 0.3f, 0.3f}, 0.0f},    // Rouge diffus
+    //{1, 0.2f, 1.0f, 0.0f, {0.9f, 0.6f, 0.2f}, 0.0f},    // Métal doré
+    //{2, 0.1f, 1.3f, 0.0f, {0.3f, 0.7f, 0.9f}, 0.0f},    // Verre bleuté
+};
+
+// Dans scene.cpp, ajustez la définition des murs selon vos besoins
+Block blocks[MAX_BLOCKS] = {
+    {{0.0f, -1.0f, 0.0f}, {20.0f, 0.1f, 20.0f}},  // Sol
+    {{0.0f, 10.0f, 0.0f}, {20.0f, 0.1f, 20.0f}},  // Plafond
+    {{-10.0f, 0.0f, 0.0f}, {0.1f, 20.0f, 20.0f}}, // Mur gauche
+    {{10.0f, 0.0f, 0.0f}, {0.1f, 20.0f, 20.0f}},  // Mur droit
+    {{0.0f, 0.0f, -10.0f}, {20.0f, 20.0f, 0.1f}}, // Mur arrière
+    {{0.0f, 0.0f, 10.0f}, {20.0f, 20.0f, 0.1f}}   // Mur avant
+};
+
+Material2 materials_block[MAX_BLOCKS] = {
+    {1, 0.80f, 1.0f, 0.0f, {0.2f, 0.2f, 0.225f}, 0.0f}, // Mur gauche gris
+    {1, 0.80f, 1.0f, 0.0f, {0.2f, 0.2f, 0.225f}, 0.0f}, // Mur droit gris
+    {1, 0.80f, 1.0f, 0.0f, {0.2f, 0.2f, 0.225f}, 0.0f}, // Mur arrière gris
+    {1, 0.80f, 1.0f, 0.0f, {0.2f, 0.2f, 0.225f}, 0.0f}, // Mur avant gris
+    {1, 0.80f, 1.0f, 0.0f, {0.2f, 0.2f, 0.225f}, 0.0f}, // Mur gauche avant gris
+    {1, 0.80f, 1.0f, 0.0f, {0.2f, 0.2f, 0.225f}, 0.0f}  // Mur droit avant gris
+};
+
+
+// Position de la lumière
+Vector3 lightPos = {5.0f, 10.0f, -2.0f};
+// Couleur de la lumière
+Vector3 lightColor = {1.0f, 0.9f, 0.8f}; // Lumière légèrement chaude
+// Intensité de la lumière
+float lightIntensity = 5.0f;
@@ -0,0 +1,52 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include "raylib.h"
+
+// Description de la scène partagée entre le rendu GPU (main.cpp + raytest.fs)
+// et le traceur CPU (cpu_tracer.cpp)
+
+#define MAX_SPHERES 2
+#define MAX_BLOCKS 6
+
+// Types de matériaux (identiques à raytest.fs)
+#define MAT_DIFFUSE 0
+#define MAT_METALLIC 1
+#define MAT_GLASS 2
+#define MAT_EMISSIVE 3
+#define MAT_MIRROR 4
+
+// Structure pour les sphères
+typedef struct {
+    Vector3 position;
+    float radius;
+} Sphere;
+
+//structure pour les blocs (murs)
+typedef struct {
+    Vector3 position;
+    Vector3 size; // Taille du bloc (largeur, hauteur, profondeur)
+} Block;
+
+// Structure pour les matériaux
+typedef struct {
+    int type;         // 0 = diffus, 1 = métallique, 2 = verre, 3 = emissif, 4 = miroir
+    float roughness;  // 0.0 - 1.0
+    float ior;        // indice de réfraction (verre)
+    float padding;    // pour alignement
+    Vector3 albedo;   // couleur
+    float padding2;   // pour alignement
+} Material2;
+
+// Données de la scène (définies dans scene.cpp)
+extern Sphere spheres[MAX_SPHERES];
+extern Material2 materials[MAX_SPHERES];
+extern Block blocks[MAX_BLOCKS];
+extern Material2 materials_block[MAX_BLOCKS];
+
+// Lumière
+extern Vector3 lightPos;
+extern Vector3 lightColor;
+extern float lightIntensity;
+
+#endif // SCENE_H
@@ -0,0 +1,66 @@
+// Conversion des scènes texte en fichiers binaires projetés en mémoire (voir scene_file.h)
+//
+// Utilisation : ./scene_convert scene.txt scene.rtscene [--no-bvh]
+//               ./scene_convert --dump scene.rtscene scene.txt
+//               ./scene_convert --default scene.txt
+//
+// Le BVH (SAH) est construit à la conversion et stocké dans le fichier : le chargement
+// ne fait plus que projeter le fichier. --dump relit un fichier binaire en texte,
+// --default écrit la scène intégrée (scene.cpp) en texte.
+#include "scene_file.h"
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+static void printUsage(const char *program) {
+    printf("Utilisation : %s scene.txt scene.rtscene [--no-bvh]\n", program);
+    printf("              %s --dump scene.rtscene scene.txt\n", program);
+    printf("              %s --default scene.txt\n", program);
+}
+
+int main(int argc, char **argv) {
+    if (argc == 4 && strcmp(argv[1], "--dump") == 0) {
+        SceneFile file;
+        if (!loadSceneFile(&file, argv[2])) return 1;
+        bool ok = saveSceneText(argv[3], &file.soa, &file.info);
+        unloadSceneFile(&file);
+        if (!ok) fprintf(stderr, "Impossible d'ecrire %s\n", argv[3]);
+        return ok ? 0 : 1;
+    }
+
+    if (argc == 3 && strcmp(argv[1], "--default") == 0) {
+        SceneSoA soa;
+        if (!loadSceneSoAFromArrays(&soa, spheres, materials, MAX_SPHERES, blocks, materials_block, MAX_BLOCKS)) return 1;
+        SceneInfo info = defaultSceneInfo();
+        bool ok = saveSceneText(argv[2], &soa, &info);
+        unloadSceneSoA(&soa);
+        if (!ok) fprintf(stderr, "Impossible d'ecrire %s\n", argv[2]);
+        return ok ? 0 : 1;
+    }
+
+    bool withBvh = true;
+    if (argc == 4 && strcmp(argv[3], "--no-bvh") == 0) withBvh = false;
+    else if (argc != 3 || argv[1][0] == '-') {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    SceneSoA soa;
+    SceneInfo info;
+    if (!loadSceneText(argv[1], &soa, &info)) return 1;
+
+    Bvh bvh;
+    if (withBvh && soa.sphereCount + soa.blockCount + soa.triangleCount > 0) buildBvh(&bvh, &soa);
+    bool ok = saveSceneFile(argv[2], &soa, withBvh ? &bvh : NULL, &info);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (ok) {
+        printf("%s : %d spheres, %d blocs, %d triangles, %d noeuds BVH -> %s (%.1f ms)\n", argv[1], soa.sphereCount,
+               soa.blockCount, soa.triangleCount, (int)bvh.nodes.size(), argv[2], ms);
+    } else {
+        fprintf(stderr, "Impossible d'ecrire %s\n", argv[2]);
+    }
+    unloadSceneSoA(&soa);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,432 @@
+#include "scene_file.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOGDI
+    #define NOUSER
+    #include <windows.h>
+    #undef near
+    #undef far
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+static inline uint64_t alignOffset(uint64_t offset) {
+    return (offset + SCENE_SOA_ALIGN - 1) / SCENE_SOA_ALIGN * SCENE_SOA_ALIGN;
+}
+
+static Vector3 toVector3(const float *v) {
+    return (Vector3){ v[0], v[1], v[2] };
+}
+
+static void fromVector3(float *out, Vector3 v) {
+    out[0] = v.x; out[1] = v.y; out[2] = v.z;
+}
+
+SceneInfo defaultSceneInfo(void) {
+    SceneInfo info;
+    info.cameraEye = (Vector3){ 0.0f, 0.0f, 5.0f };
+    info.cameraTarget = (Vector3){ 0.0f, 0.0f, 0.0f };
+    info.cameraFovy = 60.0f;
+    info.lightPos = lightPos;
+    info.lightColor = lightColor;
+    info.lightIntensity = lightIntensity;
+    return info;
+}
+
+// Projection privée en lecture / écriture : les pages ne sont copiées que si la scène est modifiée
+static bool mapFile(SceneFile *file, const char *fileName) {
+#if defined(_WIN32)
+    HANDLE fileHandle = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (fileHandle == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(fileHandle, &size) || size.QuadPart == 0) {
+        CloseHandle(fileHandle);
+        return false;
+    }
+    HANDLE mapHandle = CreateFileMappingA(fileHandle, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    void *mapping = mapHandle ? MapViewOfFile(mapHandle, FILE_MAP_COPY, 0, 0, 0) : NULL;
+    if (mapping == NULL) {
+        if (mapHandle) CloseHandle(mapHandle);
+        CloseHandle(fileHandle);
+        return false;
+    }
+    file->fileHandle = fileHandle;
+    file->mapHandle = mapHandle;
+    file->mapping = mapping;
+    file->mappingSize = (size_t)size.QuadPart;
+#else
+    int fd = open(fileName, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void *mapping = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);  // la projection reste valide
+    if (mapping == MAP_FAILED) return false;
+    file->mapping = mapping;
+    file->mappingSize = (size_t)st.st_size;
+#endif
+    return true;
+}
+
+static void unmapFile(SceneFile *file) {
+    if (file->mapping == NULL) return;
+#if defined(_WIN32)
+    UnmapViewOfFile(file->mapping);
+    CloseHandle((HANDLE)file->mapHandle);
+    CloseHandle((HANDLE)file->fileHandle);
+#else
+    munmap(file->mapping, file->mappingSize);
+#endif
+    file->mapping = NULL;
+    file->mappingSize = 0;
+}
+
+static bool sectionFits(uint64_t offset, uint64_t size, uint64_t fileSize) {
+    return offset % SCENE_SOA_ALIGN == 0 && offset <= fileSize && size <= fileSize - offset;
+}
+
+// Indices du BVH dans les bornes et profondeur au plus BVH_STACK_SIZE - 2 (la borne de
+// buildBvh) : un fichier corrompu ne doit pas faire sortir le parcours des tableaux ni de sa pile
+static bool bvhIndicesValid(const SceneFileHeader *header, const BvhNode *nodes, const int32_t *primRefs) {
+    // Les enfants suivent toujours leur parent : la profondeur se propage en un seul passage
+    std::vector<int> depth(header->bvhNodeCount, 0);
+    for (int i = 0; i < header->bvhNodeCount; i++) {
+        const BvhNode *node = &nodes[i];
+        bool ok = node->count > 0
+            ? node->leftFirst >= 0 && node->count <= header->bvhPrimRefCount - node->leftFirst
+            : node->count == 0 && node->leftFirst > i && node->leftFirst + 1 < header->bvhNodeCount;
+        if (!ok || depth[i] > BVH_STACK_SIZE - 2) return false;
+        if (node->count == 0) {
+            for (int child = node->leftFirst; child <= node->leftFirst + 1; child++) {
+                if (depth[child] < depth[i] + 1) depth[child] = depth[i] + 1;
+            }
+        }
+    }
+    for (int i = 0; i < header->bvhPrimRefCount; i++) {
+        int index = bvhPrimIndex(primRefs[i]);
+        int type = bvhPrimType(primRefs[i]);
+        int count = type == BVH_PRIM_SPHERE ? header->sphereCount
+                  : (type == BVH_PRIM_BLOCK ? header->blockCount
+                  : (type == BVH_PRIM_TRIANGLE ? header->triangleCount : 0));
+        if (index < 0 || index >= count) return false;
+    }
+    return true;
+}
+
+bool loadSceneFile(SceneFile *file, const char *fileName) {
+    file->soa = SceneSoA();
+    file->bvh = (BvhView){ NULL, 0, NULL, 0 };
+    file->mapping = NULL;
+    file->mappingSize = 0;
+    file->fileHandle = NULL;
+    file->mapHandle = NULL;
+
+    if (!mapFile(file, fileName)) {
+        fprintf(stderr, "%s : impossible d'ouvrir le fichier\n", fileName);
+        return false;
+    }
+
+    const SceneFileHeader *header = (const SceneFileHeader *)file->mapping;
+    uint64_t fileSize = file->mappingSize;
+    bool valid = fileSize >= sizeof(SceneFileHeader)
+        && header->magic == SCENE_FILE_MAGIC && header->version == SCENE_FILE_VERSION
+        && header->headerSize == sizeof(SceneFileHeader) && header->fileSize == fileSize
+        && header->sphereCount >= 0 && header->blockCount >= 0 && header->triangleCount >= 0
+        && header->bvhNodeCount >= 0 && header->bvhPrimRefCount >= 0;
+    if (valid) {
+        valid = sectionFits(header->soaOffset, sceneSoASize(header->sphereCount, header->blockCount, header->triangleCount), fileSize)
+            && sectionFits(header->bvhNodesOffset, (uint64_t)header->bvhNodeCount * sizeof(BvhNode), fileSize)
+            && sectionFits(header->bvhPrimRefsOffset, (uint64_t)header->bvhPrimRefCount * sizeof(int32_t), fileSize);
+    }
+    // Sections lues seulement une fois l'en-tête et leurs bornes vérifiés (fichier tronqué)
+    uint8_t *base = (uint8_t *)file->mapping;
+    const BvhNode *nodes = NULL;
+    const int32_t *primRefs = NULL;
+    if (valid) {
+        nodes = (const BvhNode *)(base + header->bvhNodesOffset);
+        primRefs = (const int32_t *)(base + header->bvhPrimRefsOffset);
+        valid = bvhIndicesValid(header, nodes, primRefs);
+    }
+    if (!valid) {
+        fprintf(stderr, "%s : pas une scene version %d valide\n", fileName, SCENE_FILE_VERSION);
+        unmapFile(file);
+        return false;
+    }
+
+    bindSceneSoA(&file->soa, base + header->soaOffset, header->sphereCount, header->blockCount, header->triangleCount);
+    file->bvh = (BvhView){ nodes, header->bvhNodeCount, (const int *)primRefs, header->bvhPrimRefCount };
+
+    file->info.cameraEye = toVector3(header->cameraEye);
+    file->info.cameraTarget = toVector3(header->cameraTarget);
+    file->info.cameraFovy = header->cameraFovy;
+    file->info.lightPos = toVector3(header->lightPos);
+    file->info.lightColor = toVector3(header->lightColor);
+    file->info.lightIntensity = header->lightIntensity;
+    return true;
+}
+
+void unloadSceneFile(SceneFile *file) {
+    unmapFile(file);
+    file->soa = SceneSoA();
+    file->bvh = (BvhView){ NULL, 0, NULL, 0 };
+}
+
+bool saveSceneFile(const char *fileName, const SceneSoA *scene, const Bvh *bvh, const SceneInfo *info) {
+    SceneFileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = SCENE_FILE_MAGIC;
+    header.version = SCENE_FILE_VERSION;
+    header.headerSize = sizeof(SceneFileHeader);
+    header.sphereCount = scene->sphereCount;
+    header.blockCount = scene->blockCount;
+    header.triangleCount = scene->triangleCount;
+    header.bvhNodeCount = bvh ? (int32_t)bvh->nodes.size() : 0;
+    header.bvhPrimRefCount = bvh ? (int32_t)bvh->primRefs.size() : 0;
+
+    size_t soaSize = sceneSoASize(scene->sphereCount, scene->blockCount, scene->triangleCount);
+    header.soaOffset = alignOffset(sizeof(SceneFileHeader));
+    header.bvhNodesOffset = alignOffset(header.soaOffset + soaSize);
+    header.bvhPrimRefsOffset = alignOffset(header.bvhNodesOffset + (uint64_t)header.bvhNodeCount * sizeof(BvhNode));
+    header.fileSize = header.bvhPrimRefsOffset + (uint64_t)header.bvhPrimRefCount * sizeof(int32_t);
+
+    fromVector3(header.cameraEye, info->cameraEye);
+    fromVector3(header.cameraTarget, info->cameraTarget);
+    header.cameraFovy = info->cameraFovy;
+    fromVector3(header.lightPos, info->lightPos);
+    fromVector3(header.lightColor, info->lightColor);
+    header.lightIntensity = info->lightIntensity;
+
+    // Image complète du fichier (espaces d'alignement à zéro) écrite en une fois
+    std::vector<uint8_t> image(header.fileSize, 0);
+    memcpy(image.data(), &header, sizeof(header));
+    // Une scène projetée depuis un fichier n'a pas de memory : la zone commence au premier tableau
+    const void *soaData = scene->memory ? scene->memory : (const void *)scene->sphereX;
+    memcpy(image.data() + header.soaOffset, soaData, soaSize);
+    if (header.bvhNodeCount > 0) {
+        memcpy(image.data() + header.bvhNodesOffset, bvh->nodes.data(), header.bvhNodeCount * sizeof(BvhNode));
+    }
+    if (header.bvhPrimRefCount > 0) {
+        memcpy(image.data() + header.bvhPrimRefsOffset, bvh->primRefs.data(), header.bvhPrimRefCount * sizeof(int32_t));
+    }
+
+    FILE *out = fopen(fileName, "wb");
+    if (out == NULL) return false;
+    bool ok = fwrite(image.data(), 1, image.size(), out) == image.size();
+    ok = fclose(out) == 0 && ok;
+    return ok;
+}
+
+// Format texte
+
+static const char *materialTypeNames[] = { "diffuse", "metal", "glass", "emissive", "mirror" };
+static const int materialTypeCount = 5;
+
+static int findMaterialType(const char *name) {
+    for (int i = 0; i < materialTypeCount; i++) {
+        if (strcmp(name, materialTypeNames[i]) == 0) return i;
+    }
+    return -1;
+}
+
+typedef struct {
+    Vector3 position;
+    Vector3 size;       // blocs seulement
+    float radius;       // sphères seulement
+    int material;
+} TextPrimitive;
+
+typedef struct {
+    Vector3 v0, v1, v2;
+    int material;
+} TextTriangle;
+
+bool loadSceneText(const char *fileName, SceneSoA *scene, SceneInfo *info) {
+    FILE *in = fopen(fileName, "r");
+    if (in == NULL) {
+        fprintf(stderr, "%s : impossible d'ouvrir le fichier\n", fileName);
+        return false;
+    }
+
+    *info = defaultSceneInfo();
+    std::map<std::string, int> materialIndex;
+    std::vector<Material2> materialList;
+    std::vector<TextPrimitive> sphereList, blockList;
+    std::vector<TextTriangle> triangleList;
+
+    char line[512];
+    int lineNumber = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), in) != NULL) {
+        lineNumber++;
+        char keyword[32] = "", name[64] = "", typeName[32] = "";
+        if (sscanf(line, "%31s", keyword) != 1 || keyword[0] == '#') continue;
+
+        TextPrimitive prim = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }, 0.0f, -1 };
+        Material2 mat = { 0, 0.0f, 1.0f, 0.0f, { 0.0f, 0.0f, 0.0f }, 0.0f };
+        if (strcmp(keyword, "camera") == 0) {
+            ok = sscanf(line, "%*s %f %f %f %f %f %f %f", &info->cameraEye.x, &info->cameraEye.y, &info->cameraEye.z,
+                        &info->cameraTarget.x, &info->cameraTarget.y, &info->cameraTarget.z, &info->cameraFovy) == 7;
+        } else if (strcmp(keyword, "light") == 0) {
+            ok = sscanf(line, "%*s %f %f %f %f %f %f %f", &info->lightPos.x, &info->lightPos.y, &info->lightPos.z,
+                        &info->lightColor.x, &info->lightColor.y, &info->lightColor.z, &info->lightIntensity) == 7;
+        } else if (strcmp(keyword, "material") == 0) {
+            ok = sscanf(line, "%*s %63s %31s %f %f %f %f %f", name, typeName, &mat.roughness, &mat.ior,
+                        &mat.albedo.x, &mat.albedo.y, &mat.albedo.z) == 7;
+            mat.type = ok ? findMaterialType(typeName) : -1;
+            ok = ok && mat.type >= 0 && materialIndex.find(name) == materialIndex.end();
+            if (ok) {
+                materialIndex[name] = (int)materialList.size();
+                materialList.push_back(mat);
+            }
+        } else if (strcmp(keyword, "sphere") == 0) {
+            ok = sscanf(line, "%*s %f %f %f %f %63s", &prim.position.x, &prim.position.y, &prim.position.z,
+                        &prim.radius, name) == 5 && materialIndex.count(name) == 1;
+            if (ok) {
+                prim.material = materialIndex[name];
+                sphereList.push_back(prim);
+            }
+        } else if (strcmp(keyword, "block") == 0) {
+            ok = sscanf(line, "%*s %f %f %f %f %f %f %63s", &prim.position.x, &prim.position.y, &prim.position.z,
+                        &prim.size.x, &prim.size.y, &prim.size.z, name) == 7 && materialIndex.count(name) == 1;
+            if (ok) {
+                prim.material = materialIndex[name];
+                blockList.push_back(prim);
+            }
+        } else if (strcmp(keyword, "triangle") == 0) {
+            TextTriangle tri;
+            ok = sscanf(line, "%*s %f %f %f %f %f %f %f %f %f %63s", &tri.v0.x, &tri.v0.y, &tri.v0.z,
+                        &tri.v1.x, &tri.v1.y, &tri.v1.z, &tri.v2.x, &tri.v2.y, &tri.v2.z, name) == 10
+                 && materialIndex.count(name) == 1;
+            if (ok) {
+                tri.material = materialIndex[name];
+                triangleList.push_back(tri);
+            }
+        } else {
+            ok = false;
+        }
+        if (!ok) fprintf(stderr, "%s:%d : ligne invalide : %s", fileName, lineNumber, line);
+    }
+    fclose(in);
+    if (!ok) return false;
+
+    if (!loadSceneSoA(scene, (int)sphereList.size(), (int)blockList.size(), (int)triangleList.size())) {
+        fprintf(stderr, "%s : allocation de la scene impossible\n", fileName);
+        return false;
+    }
+    for (size_t i = 0; i < sphereList.size(); i++) {
+        scene->sphereX[i] = sphereList[i].position.x;
+        scene->sphereY[i] = sphereList[i].position.y;
+        scene->sphereZ[i] = sphereList[i].position.z;
+        scene->sphereRadius[i] = sphereList[i].radius;
+        setMaterial(&scene->sphereMaterials, (int)i, materialList[sphereList[i].material]);
+    }
+    for (size_t i = 0; i < blockList.size(); i++) {
+        scene->blockX[i] = blockList[i].position.x;
+        scene->blockY[i] = blockList[i].position.y;
+        scene->blockZ[i] = blockList[i].position.z;
+        scene->blockSizeX[i] = blockList[i].size.x;
+        scene->blockSizeY[i] = blockList[i].size.y;
+        scene->blockSizeZ[i] = blockList[i].size.z;
+        setMaterial(&scene->blockMaterials, (int)i, materialList[blockList[i].material]);
+    }
+    for (size_t i = 0; i < triangleList.size(); i++) {
+        setTriangle(scene, (int)i, triangleList[i].v0, triangleList[i].v1, triangleList[i].v2);
+        setMaterial(&scene->triangleMaterials, (int)i, materialList[triangleList[i].material]);
+    }
+    return true;
+}
+
+// Écriture la plus courte qui relit exactement le même flottant
+static void formatFloat(char *text, size_t size, float value) {
+    snprintf(text, size, "%g", value);
+    if (strtof(text, NULL) != value) snprintf(text, size, "%.9g", value);
+}
+
+static void writeFloats(FILE *out, const float *values, int count) {
+    for (int i = 0; i < count; i++) {
+        char text[32];
+        formatFloat(text, sizeof(text), values[i]);
+        fprintf(out, i == 0 ? "%s" : " %s", text);
+    }
+}
+
+// Nom du matériau, les matériaux identiques partagent le même nom
+static const char *materialName(std::map<std::string, std::string> *names, FILE *out, Material2 mat) {
+    int type = (mat.type >= 0 && mat.type < materialTypeCount) ? mat.type : 0;
+    float values[5] = { mat.roughness, mat.ior, mat.albedo.x, mat.albedo.y, mat.albedo.z };
+    char definition[256];
+    int length = snprintf(definition, sizeof(definition), "%s", materialTypeNames[type]);
+    for (int i = 0; i < 5; i++) {
+        char text[32];
+        formatFloat(text, sizeof(text), values[i]);
+        length += snprintf(definition + length, sizeof(definition) - length, " %s", text);
+    }
+
+    std::map<std::string, std::string>::iterator it = names->find(definition);
+    if (it == names->end()) {
+        char name[32];
+        snprintf(name, sizeof(name), "m%d", (int)names->size());
+        fprintf(out, "material %s %s\n", name, definition);
+        it = names->insert(std::make_pair(std::string(definition), std::string(name))).first;
+    }
+    return it->second.c_str();
+}
+
+bool saveSceneText(const char *fileName, const SceneSoA *scene, const SceneInfo *info) {
+    FILE *out = fopen(fileName, "w");
+    if (out == NULL) return false;
+
+    fprintf(out, "# camera ex ey ez  tx ty tz  fovy\n");
+    float camera[7] = { info->cameraEye.x, info->cameraEye.y, info->cameraEye.z,
+                        info->cameraTarget.x, info->cameraTarget.y, info->cameraTarget.z, info->cameraFovy };
+    fprintf(out, "camera ");
+    writeFloats(out, camera, 7);
+    fprintf(out, "\n# light px py pz  r g b  intensite");
+    float light[7] = { info->lightPos.x, info->lightPos.y, info->lightPos.z,
+                       info->lightColor.x, info->lightColor.y, info->lightColor.z, info->lightIntensity };
+    fprintf(out, "\nlight ");
+    writeFloats(out, light, 7);
+    fprintf(out, "\n");
+    fprintf(out, "# material nom type rugosite ior r g b, sphere x y z rayon materiau, block x y z sx sy sz materiau\n");
+    if (scene->triangleCount > 0) fprintf(out, "# triangle x0 y0 z0  x1 y1 z1  x2 y2 z2 materiau\n");
+
+    std::map<std::string, std::string> names;
+    for (int i = 0; i < scene->sphereCount; i++) {
+        const char *name = materialName(&names, out, getMaterial(&scene->sphereMaterials, i));
+        float values[4] = { scene->sphereX[i], scene->sphereY[i], scene->sphereZ[i], scene->sphereRadius[i] };
+        fprintf(out, "sphere ");
+        writeFloats(out, values, 4);
+        fprintf(out, " %s\n", name);
+    }
+    for (int i = 0; i < scene->blockCount; i++) {
+        const char *name = materialName(&names, out, getMaterial(&scene->blockMaterials, i));
+        float values[6] = { scene->blockX[i], scene->blockY[i], scene->blockZ[i],
+                            scene->blockSizeX[i], scene->blockSizeY[i], scene->blockSizeZ[i] };
+        fprintf(out, "block ");
+        writeFloats(out, values, 6);
+        fprintf(out, " %s\n", name);
+    }
+    for (int i = 0; i < scene->triangleCount; i++) {
+        const char *name = materialName(&names, out, getMaterial(&scene->triangleMaterials, i));
+        float values[9] = { scene->triangleV0X[i], scene->triangleV0Y[i], scene->triangleV0Z[i],
+                            scene->triangleV1X[i], scene->triangleV1Y[i], scene->triangleV1Z[i],
+                            scene->triangleV2X[i], scene->triangleV2Y[i], scene->triangleV2Z[i] };
+        fprintf(out, "triangle ");
+        writeFloats(out, values, 9);
+        fprintf(out, " %s\n", name);
+    }
+    return fclose(out) == 0;
+}
@@ -0,0 +1,82 @@
+#ifndef SCENE_FILE_H
+#define SCENE_FILE_H
+
+#include "raylib.h"
+#include "scene_soa.h"
+#include "bvh.h"
+#include <stdint.h>
+
+// Fichiers de scène binaires (.rtscene), projetés en mémoire et utilisés sans analyse :
+//   en-tête SceneFileHeader
+//   tableaux SoA dans la disposition exacte de loadSceneSoA (sceneSoASize octets)
+//   noeuds du BVH (BvhNode, 32 octets) puis références de primitives (int32)
+// Chaque section commence sur SCENE_SOA_ALIGN octets. Entiers et flottants en petit
+// boutiste. Les fichiers sont produits par scene_convert depuis le format texte :
+//
+//   # commentaire
+//   camera   ex ey ez  tx ty tz  fovy
+//   light    px py pz  r g b  intensite
+//   material nom type rugosite ior r g b      (type : diffuse metal glass emissive mirror)
+//   sphere   x y z rayon materiau
+//   block    x y z  sx sy sz materiau          (centre et taille complète)
+//   triangle x0 y0 z0  x1 y1 z1  x2 y2 z2 materiau  (sens trigonométrique vu de l'extérieur)
+
+#define SCENE_FILE_MAGIC 0x43535452u    // "RTSC"
+#define SCENE_FILE_VERSION 2    // 2 : triangles
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerSize;        // sizeof(SceneFileHeader), détecte les écarts de disposition
+    int32_t sphereCount;
+    int32_t blockCount;
+    int32_t bvhNodeCount;       // 0 si pas de BVH précalculé
+    int32_t bvhPrimRefCount;
+    int32_t triangleCount;
+    uint64_t fileSize;
+    uint64_t soaOffset;
+    uint64_t bvhNodesOffset;
+    uint64_t bvhPrimRefsOffset;
+    float cameraEye[3];
+    float cameraTarget[3];
+    float cameraFovy;
+    float lightPos[3];
+    float lightColor[3];
+    float lightIntensity;
+} SceneFileHeader;
+
+// Caméra et lumière ponctuelle décrites par le fichier
+typedef struct {
+    Vector3 cameraEye;
+    Vector3 cameraTarget;
+    float cameraFovy;
+    Vector3 lightPos;
+    Vector3 lightColor;
+    float lightIntensity;
+} SceneInfo;
+
+typedef struct {
+    SceneSoA soa;       // pointe dans la projection (copie privée : modifiable)
+    BvhView bvh;        // pointe dans la projection, nodeCount 0 si pas de BVH précalculé
+    SceneInfo info;
+    void *mapping;
+    size_t mappingSize;
+    void *fileHandle;   // Windows seulement
+    void *mapHandle;
+} SceneFile;
+
+// Projette le fichier et vérifie l'en-tête et les tailles de sections
+bool loadSceneFile(SceneFile *file, const char *fileName);
+void unloadSceneFile(SceneFile *file);
+
+// Écrit une scène (bvh peut être NULL)
+bool saveSceneFile(const char *fileName, const SceneSoA *scene, const Bvh *bvh, const SceneInfo *info);
+
+// Lecture du format texte (alloue scene, à libérer avec unloadSceneSoA)
+bool loadSceneText(const char *fileName, SceneSoA *scene, SceneInfo *info);
+bool saveSceneText(const char *fileName, const SceneSoA *scene, const SceneInfo *info);
+
+// Caméra de main.cpp et lumière de scene.cpp
+SceneInfo defaultSceneInfo(void);
+
+#endif // SCENE_FILE_H
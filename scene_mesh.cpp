@@ -0,0 +1,61 @@
+#include "scene_mesh.h"
+#include "raymath.h"
+
+static Vector3 meshVertex(const Mesh *mesh, int vertex, Matrix transform) {
+    const float *v = mesh->vertices + 3*vertex;
+    return Vector3Transform((Vector3){ v[0], v[1], v[2] }, transform);
+}
+
+// Formats lus par LoadModel
+#define MESH_FILE_EXTENSIONS ".obj;.iqm;.gltf;.glb;.vox;.m3d"
+
+int appendModelTriangles(SceneSoA *scene, const char *fileName, Material2 material) {
+    // LoadModel remplace un fichier absent ou illisible par un cube : à vérifier avant
+    if (!FileExists(fileName)) {
+        TraceLog(LOG_ERROR, "MESH: %s : fichier introuvable", fileName);
+        return -1;
+    }
+    if (!IsFileExtension(fileName, MESH_FILE_EXTENSIONS)) {
+        TraceLog(LOG_ERROR, "MESH: %s : format non pris en charge (%s)", fileName, MESH_FILE_EXTENSIONS);
+        return -1;
+    }
+    Model model = LoadModel(fileName);
+    if (model.meshCount == 0 || model.meshes == NULL) {
+        TraceLog(LOG_ERROR, "MESH: %s : aucun maillage", fileName);
+        UnloadModel(model);
+        return -1;
+    }
+
+    int added = 0;
+    for (int m = 0; m < model.meshCount; m++) {
+        if (model.meshes[m].vertices != NULL) added += model.meshes[m].triangleCount;
+    }
+
+    SceneSoA grown;
+    if (!growSceneTriangles(&grown, scene, added)) {
+        TraceLog(LOG_ERROR, "MESH: %s : allocation de %d triangles impossible", fileName, added);
+        UnloadModel(model);
+        return -1;
+    }
+
+    int index = scene->triangleCount;
+    for (int m = 0; m < model.meshCount; m++) {
+        const Mesh *mesh = &model.meshes[m];
+        if (mesh->vertices == NULL) continue;
+        for (int t = 0; t < mesh->triangleCount; t++, index++) {
+            // Maillage indexé ou suite de triangles
+            int i0 = mesh->indices ? mesh->indices[3*t] : 3*t;
+            int i1 = mesh->indices ? mesh->indices[3*t + 1] : 3*t + 1;
+            int i2 = mesh->indices ? mesh->indices[3*t + 2] : 3*t + 2;
+            setTriangle(&grown, index, meshVertex(mesh, i0, model.transform), meshVertex(mesh, i1, model.transform),
+                        meshVertex(mesh, i2, model.transform));
+            setMaterial(&grown.triangleMaterials, index, material);
+        }
+    }
+    UnloadModel(model);
+
+    unloadSceneSoA(scene);
+    *scene = grown;
+    TraceLog(LOG_INFO, "MESH: %s : %d triangles ajoutes", fileName, added);
+    return added;
+}
@@ -0,0 +1,17 @@
+#ifndef SCENE_MESH_H
+#define SCENE_MESH_H
+
+#include "raylib.h"
+#include "scene_soa.h"
+
+// Ajout des triangles d'un modèle chargé par LoadModel (obj, gltf, iqm...) à la scène SoA.
+// Les sommets sont transformés par model.transform ; tous les triangles reçoivent le même
+// matériau. Nécessite un contexte OpenGL (LoadModel envoie les maillages au GPU).
+
+// Remplace *scene par une nouvelle allocation (l'ancienne est libérée si elle lui
+// appartient, une scène projetée depuis un fichier reste valide jusqu'à unloadSceneFile).
+// Retourne le nombre de triangles ajoutés, -1 en cas d'erreur (scène inchangée), y compris
+// pour un fichier absent ou d'extension inconnue que LoadModel remplacerait par un cube.
+int appendModelTriangles(SceneSoA *scene, const char *fileName, Material2 material);
+
+#endif // SCENE_MESH_H
@@ -0,0 +1,280 @@
+#include "scene_soa.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// Nombre d'éléments arrondi pour que chaque tableau commence sur une ligne de cache
+static inline size_t paddedCount(int count) {
+    const size_t perLine = SCENE_SOA_ALIGN / sizeof(float);
+    return ((size_t)count + perLine - 1) / perLine * perLine;
+}
+
+static void *alignedAlloc(size_t size) {
+#if defined(_WIN32)
+    return _aligned_malloc(size, SCENE_SOA_ALIGN);
+#else
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, SCENE_SOA_ALIGN, size) != 0) return NULL;
+    return ptr;
+#endif
+}
+
+static void alignedFree(void *ptr) {
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+// Découpe séquentielle de l'allocation (int et float font 4 octets)
+static inline float *takeArray(uint8_t **cursor, int count) {
+    float *array = (float *)*cursor;
+    *cursor += paddedCount(count) * sizeof(float);
+    return array;
+}
+
+static void takeMaterials(uint8_t **cursor, MaterialArrays *materials, int count) {
+    materials->type = (int *)takeArray(cursor, count);
+    materials->roughness = takeArray(cursor, count);
+    materials->ior = takeArray(cursor, count);
+    materials->albedoR = takeArray(cursor, count);
+    materials->albedoG = takeArray(cursor, count);
+    materials->albedoB = takeArray(cursor, count);
+}
+
+size_t sceneSoASize(int sphereCount, int blockCount, int triangleCount) {
+    // 4 composantes + 6 pour les matériaux par sphère, 6 + 6 par bloc, 9 + 6 par triangle
+    size_t size = (10*paddedCount(sphereCount) + 12*paddedCount(blockCount) + 15*paddedCount(triangleCount)) * sizeof(float);
+    return size == 0 ? SCENE_SOA_ALIGN : size;
+}
+
+bool loadSceneSoA(SceneSoA *scene, int sphereCount, int blockCount, int triangleCount) {
+    size_t size = sceneSoASize(sphereCount, blockCount, triangleCount);
+    void *memory = alignedAlloc(size);
+    if (memory == NULL) {
+        memset(scene, 0, sizeof(SceneSoA));
+        return false;
+    }
+    memset(memory, 0, size);
+    bindSceneSoA(scene, memory, sphereCount, blockCount, triangleCount);
+    scene->memory = memory;
+    return true;
+}
+
+void bindSceneSoA(SceneSoA *scene, void *memory, int sphereCount, int blockCount, int triangleCount) {
+    memset(scene, 0, sizeof(SceneSoA));
+    uint8_t *cursor = (uint8_t *)memory;
+    scene->sphereCount = sphereCount;
+    scene->sphereX = takeArray(&cursor, sphereCount);
+    scene->sphereY = takeArray(&cursor, sphereCount);
+    scene->sphereZ = takeArray(&cursor, sphereCount);
+    scene->sphereRadius = takeArray(&cursor, sphereCount);
+    takeMaterials(&cursor, &scene->sphereMaterials, sphereCount);
+
+    scene->blockCount = blockCount;
+    scene->blockX = takeArray(&cursor, blockCount);
+    scene->blockY = takeArray(&cursor, blockCount);
+    scene->blockZ = takeArray(&cursor, blockCount);
+    scene->blockSizeX = takeArray(&cursor, blockCount);
+    scene->blockSizeY = takeArray(&cursor, blockCount);
+    scene->blockSizeZ = takeArray(&cursor, blockCount);
+    takeMaterials(&cursor, &scene->blockMaterials, blockCount);
+
+    scene->triangleCount = triangleCount;
+    scene->triangleV0X = takeArray(&cursor, triangleCount);
+    scene->triangleV0Y = takeArray(&cursor, triangleCount);
+    scene->triangleV0Z = takeArray(&cursor, triangleCount);
+    scene->triangleV1X = takeArray(&cursor, triangleCount);
+    scene->triangleV1Y = takeArray(&cursor, triangleCount);
+    scene->triangleV1Z = takeArray(&cursor, triangleCount);
+    scene->triangleV2X = takeArray(&cursor, triangleCount);
+    scene->triangleV2Y = takeArray(&cursor, triangleCount);
+    scene->triangleV2Z = takeArray(&cursor, triangleCount);
+    takeMaterials(&cursor, &scene->triangleMaterials, triangleCount);
+}
+
+static void copyArray(float *dst, const float *src, int count) {
+    if (count > 0) memcpy(dst, src, count * sizeof(float));
+}
+
+static void copyMaterials(MaterialArrays *dst, const MaterialArrays *src, int count) {
+    copyArray((float *)dst->type, (const float *)src->type, count);
+    copyArray(dst->roughness, src->roughness, count);
+    copyArray(dst->ior, src->ior, count);
+    copyArray(dst->albedoR, src->albedoR, count);
+    copyArray(dst->albedoG, src->albedoG, count);
+    copyArray(dst->albedoB, src->albedoB, count);
+}
+
+bool growSceneTriangles(SceneSoA *grown, const SceneSoA *scene, int extraTriangles) {
+    int sphereCount = scene->sphereCount, blockCount = scene->blockCount, triangleCount = scene->triangleCount;
+    if (!loadSceneSoA(grown, sphereCount, blockCount, triangleCount + extraTriangles)) return false;
+
+    // Les tableaux sont recopiés un par un : le remplissage d'alignement change avec triangleCount
+    copyArray(grown->sphereX, scene->sphereX, sphereCount);
+    copyArray(grown->sphereY, scene->sphereY, sphereCount);
+    copyArray(grown->sphereZ, scene->sphereZ, sphereCount);
+    copyArray(grown->sphereRadius, scene->sphereRadius, sphereCount);
+    copyMaterials(&grown->sphereMaterials, &scene->sphereMaterials, sphereCount);
+
+    copyArray(grown->blockX, scene->blockX, blockCount);
+    copyArray(grown->blockY, scene->blockY, blockCount);
+    copyArray(grown->blockZ, scene->blockZ, blockCount);
+    copyArray(grown->blockSizeX, scene->blockSizeX, blockCount);
+    copyArray(grown->blockSizeY, scene->blockSizeY, blockCount);
+    copyArray(grown->blockSizeZ, scene->blockSizeZ, blockCount);
+    copyMaterials(&grown->blockMaterials, &scene->blockMaterials, blockCount);
+
+    copyArray(grown->triangleV0X, scene->triangleV0X, triangleCount);
+    copyArray(grown->triangleV0Y, scene->triangleV0Y, triangleCount);
+    copyArray(grown->triangleV0Z, scene->triangleV0Z, triangleCount);
+    copyArray(grown->triangleV1X, scene->triangleV1X, triangleCount);
+    copyArray(grown->triangleV1Y, scene->triangleV1Y, triangleCount);
+    copyArray(grown->triangleV1Z, scene->triangleV1Z, triangleCount);
+    copyArray(grown->triangleV2X, scene->triangleV2X, triangleCount);
+    copyArray(grown->triangleV2Y, scene->triangleV2Y, triangleCount);
+    copyArray(grown->triangleV2Z, scene->triangleV2Z, triangleCount);
+    copyMaterials(&grown->triangleMaterials, &scene->triangleMaterials, triangleCount);
+    return true;
+}
+
+bool loadSceneSoAFromArrays(SceneSoA *scene, const Sphere *spheres, const Material2 *sphereMaterials, int sphereCount,
+                            const Block *blocks, const Material2 *blockMaterials, int blockCount) {
+    if (!loadSceneSoA(scene, sphereCount, blockCount, 0)) return false;
+
+    for (int i = 0; i < sphereCount; i++) {
+        scene->sphereX[i] = spheres[i].position.x;
+        scene->sphereY[i] = spheres[i].position.y;
+        scene->sphereZ[i] = spheres[i].position.z;
+        scene->sphereRadius[i] = spheres[i].radius;
+        setMaterial(&scene->sphereMaterials, i, sphereMaterials[i]);
+    }
+    for (int i = 0; i < blockCount; i++) {
+        scene->blockX[i] = blocks[i].position.x;
+        scene->blockY[i] = blocks[i].position.y;
+        scene->blockZ[i] = blocks[i].position.z;
+        scene->blockSizeX[i] = blocks[i].size.x;
+        scene->blockSizeY[i] = blocks[i].size.y;
+        scene->blockSizeZ[i] = blocks[i].size.z;
+        setMaterial(&scene->blockMaterials, i, blockMaterials[i]);
+    }
+    return true;
+}
+
+void unloadSceneSoA(SceneSoA *scene) {
+    if (scene->memory != NULL) alignedFree(scene->memory);
+    memset(scene, 0, sizeof(SceneSoA));
+}
+
+Material2 getMaterial(const MaterialArrays *materials, int index) {
+    Material2 material;
+    material.type = materials->type[index];
+    material.roughness = materials->roughness[index];
+    material.ior = materials->ior[index];
+    material.padding = 0.0f;
+    material.albedo.x = materials->albedoR[index];
+    material.albedo.y = materials->albedoG[index];
+    material.albedo.z = materials->albedoB[index];
+    material.padding2 = 0.0f;
+    return material;
+}
+
+void setMaterial(MaterialArrays *materials, int index, Material2 material) {
+    materials->type[index] = material.type;
+    materials->roughness[index] = material.roughness;
+    materials->ior[index] = material.ior;
+    materials->albedoR[index] = material.albedo.x;
+    materials->albedoG[index] = material.albedo.y;
+    materials->albedoB[index] = material.albedo.z;
+}
+
+void getTriangle(const SceneSoA *scene, int index, Vector3 *v0, Vector3 *v1, Vector3 *v2) {
+    *v0 = (Vector3){ scene->triangleV0X[index], scene->triangleV0Y[index], scene->triangleV0Z[index] };
+    *v1 = (Vector3){ scene->triangleV1X[index], scene->triangleV1Y[index], scene->triangleV1Z[index] };
+    *v2 = (Vector3){ scene->triangleV2X[index], scene->triangleV2Y[index], scene->triangleV2Z[index] };
+}
+
+void setTriangle(SceneSoA *scene, int index, Vector3 v0, Vector3 v1, Vector3 v2) {
+    scene->triangleV0X[index] = v0.x; scene->triangleV0Y[index] = v0.y; scene->triangleV0Z[index] = v0.z;
+    scene->triangleV1X[index] = v1.x; scene->triangleV1Y[index] = v1.y; scene->triangleV1Z[index] = v1.z;
+    scene->triangleV2X[index] = v2.x; scene->triangleV2Y[index] = v2.y; scene->triangleV2Z[index] = v2.z;
+}
+
+SceneTextureLayout getSceneTextureLayout(const SceneSoA *scene) {
+    SceneTextureLayout layout;
+    layout.blockOffset = SCENE_SPHERE_TEXELS*scene->sphereCount;
+    layout.triangleOffset = layout.blockOffset + SCENE_BLOCK_TEXELS*scene->blockCount;
+    layout.lightOffset = layout.triangleOffset + SCENE_TRIANGLE_TEXELS*scene->triangleCount;
+    layout.texelCount = layout.lightOffset + (scene->sphereCount + 3)/4;
+    layout.width = SCENE_TEXTURE_WIDTH;
+    layout.height = (layout.texelCount + SCENE_TEXTURE_WIDTH - 1)/SCENE_TEXTURE_WIDTH;
+    if (layout.height < 1) layout.height = 1;
+    return layout;
+}
+
+// Deux texels : (albedo, type) (rugosité, ior, 0, 0)
+static void packMaterialTexels(const MaterialArrays *materials, int i, float *out) {
+    out[0] = materials->albedoR[i];
+    out[1] = materials->albedoG[i];
+    out[2] = materials->albedoB[i];
+    out[3] = (float)materials->type[i];
+    out[4] = materials->roughness[i];
+    out[5] = materials->ior[i];
+    out[6] = 0.0f;
+    out[7] = 0.0f;
+}
+
+void packSphereTexels(const SceneSoA *scene, int first, int count, float *texture) {
+    for (int i = first; i < first + count; i++) {
+        float *out = texture + 4*SCENE_SPHERE_TEXELS*i;
+        out[0] = scene->sphereX[i];
+        out[1] = scene->sphereY[i];
+        out[2] = scene->sphereZ[i];
+        out[3] = scene->sphereRadius[i];
+        packMaterialTexels(&scene->sphereMaterials, i, out + 4);
+    }
+}
+
+void packBlockTexels(const SceneSoA *scene, const SceneTextureLayout *layout, int first, int count, float *texture) {
+    for (int i = first; i < first + count; i++) {
+        float *out = texture + 4*(layout->blockOffset + SCENE_BLOCK_TEXELS*i);
+        out[0] = scene->blockX[i];
+        out[1] = scene->blockY[i];
+        out[2] = scene->blockZ[i];
+        out[3] = 0.0f;
+        out[4] = scene->blockSizeX[i];
+        out[5] = scene->blockSizeY[i];
+        out[6] = scene->blockSizeZ[i];
+        out[7] = 0.0f;
+        packMaterialTexels(&scene->blockMaterials, i, out + 8);
+    }
+}
+
+void packTriangleTexels(const SceneSoA *scene, const SceneTextureLayout *layout, int first, int count, float *texture) {
+    for (int i = first; i < first + count; i++) {
+        float *out = texture + 4*(layout->triangleOffset + SCENE_TRIANGLE_TEXELS*i);
+        out[0] = scene->triangleV0X[i];
+        out[1] = scene->triangleV0Y[i];
+        out[2] = scene->triangleV0Z[i];
+        out[3] = 0.0f;
+        out[4] = scene->triangleV1X[i];
+        out[5] = scene->triangleV1Y[i];
+        out[6] = scene->triangleV1Z[i];
+        out[7] = 0.0f;
+        out[8] = scene->triangleV2X[i];
+        out[9] = scene->triangleV2Y[i];
+        out[10] = scene->triangleV2Z[i];
+        out[11] = 0.0f;
+        packMaterialTexels(&scene->triangleMaterials, i, out + 12);
+    }
+}
+
+int packLightTexels(const SceneSoA *scene, const SceneTextureLayout *layout, float *texture) {
+    float *out = texture + 4*layout->lightOffset;
+    int lightCount = 0;
+    for (int i = 0; i < scene->sphereCount; i++) {
+        if (scene->sphereMaterials.type[i] == MAT_EMISSIVE) out[lightCount++] = (float)i;
+    }
+    return lightCount;
+}
@@ -0,0 +1,93 @@
+#ifndef SCENE_SOA_H
+#define SCENE_SOA_H
+
+#include "scene.h"
+#include <stddef.h>
+
+// Stockage de la scène en structure de tableaux (SoA) : une composante par tableau,
+// chaque tableau aligné sur 64 octets (une ligne de cache), sans les champs de padding
+// qui n'existent que pour l'alignement GPU. Les noyaux d'intersection CPU parcourent
+// ces tableaux ; les fonctions pack* reconstruisent la disposition attendue par raytest.fs.
+
+#define SCENE_SOA_ALIGN 64
+
+typedef struct {
+    int *type;
+    float *roughness;
+    float *ior;
+    float *albedoR, *albedoG, *albedoB;
+} MaterialArrays;
+
+typedef struct {
+    int sphereCount;
+    float *sphereX, *sphereY, *sphereZ, *sphereRadius;
+    MaterialArrays sphereMaterials;
+
+    int blockCount;
+    float *blockX, *blockY, *blockZ;             // centre du bloc
+    float *blockSizeX, *blockSizeY, *blockSizeZ; // taille complète
+    MaterialArrays blockMaterials;
+
+    int triangleCount;
+    float *triangleV0X, *triangleV0Y, *triangleV0Z;     // sommets dans le sens trigonométrique :
+    float *triangleV1X, *triangleV1Y, *triangleV1Z;     // la normale géométrique pointe vers l'extérieur
+    float *triangleV2X, *triangleV2Y, *triangleV2Z;
+    MaterialArrays triangleMaterials;
+
+    void *memory;   // allocation unique, alignée
+} SceneSoA;
+
+// Alloue une scène vide (tableaux à zéro), retourne false si l'allocation échoue
+bool loadSceneSoA(SceneSoA *scene, int sphereCount, int blockCount, int triangleCount);
+// Alloue et remplit depuis les tableaux de structures de scene.h (sans triangles)
+bool loadSceneSoAFromArrays(SceneSoA *scene, const Sphere *spheres, const Material2 *sphereMaterials, int sphereCount,
+                            const Block *blocks, const Material2 *blockMaterials, int blockCount);
+void unloadSceneSoA(SceneSoA *scene);
+
+// Taille de l'allocation de loadSceneSoA ; la même disposition est écrite telle quelle
+// dans les fichiers de scène (scene_file.h)
+size_t sceneSoASize(int sphereCount, int blockCount, int triangleCount);
+// Fait pointer les tableaux dans une zone déjà remplie, alignée sur SCENE_SOA_ALIGN et de
+// taille sceneSoASize ; memory reste NULL car la zone n'appartient pas à la scène
+void bindSceneSoA(SceneSoA *scene, void *memory, int sphereCount, int blockCount, int triangleCount);
+
+// Nouvelle scène (allouée) contenant celle-ci suivie de extraTriangles triangles à zéro
+bool growSceneTriangles(SceneSoA *grown, const SceneSoA *scene, int extraTriangles);
+
+Material2 getMaterial(const MaterialArrays *materials, int index);
+void setMaterial(MaterialArrays *materials, int index, Material2 material);
+
+void getTriangle(const SceneSoA *scene, int index, Vector3 *v0, Vector3 *v1, Vector3 *v2);
+void setTriangle(SceneSoA *scene, int index, Vector3 v0, Vector3 v1, Vector3 v2);
+
+// Texture de scène lue par raytest.fs (RGBA32F, SCENE_TEXTURE_WIDTH texels par ligne,
+// entiers stockés en flottants, exacts jusqu'à 2^24) :
+//   sphère i : 3 texels à 3*i               (position, rayon) (albedo, type) (rugosité, ior, 0, 0)
+//   bloc i   : 4 texels à blockOffset + 4*i (centre, 0) (taille, 0) (albedo, type) (rugosité, ior, 0, 0)
+//   triangle i : 5 texels à triangleOffset + 5*i (v0, 0) (v1, 0) (v2, 0) (albedo, type) (rugosité, ior, 0, 0)
+//   lumières : indices des sphères émissives, 4 par texel à partir de lightOffset
+#define SCENE_TEXTURE_WIDTH 1024    // doit rester identique à raytest.fs
+#define SCENE_SPHERE_TEXELS 3
+#define SCENE_BLOCK_TEXELS 4
+#define SCENE_TRIANGLE_TEXELS 5
+
+typedef struct {
+    int blockOffset;    // premier texel des blocs
+    int triangleOffset; // premier texel des triangles
+    int lightOffset;    // premier texel de la liste des lumières
+    int texelCount;
+    int width;
+    int height;
+} SceneTextureLayout;
+
+SceneTextureLayout getSceneTextureLayout(const SceneSoA *scene);
+
+// Écrivent les éléments [first, first + count) à leur place dans la texture complète
+// (texture : 4*width*height flottants)
+void packSphereTexels(const SceneSoA *scene, int first, int count, float *texture);
+void packBlockTexels(const SceneSoA *scene, const SceneTextureLayout *layout, int first, int count, float *texture);
+void packTriangleTexels(const SceneSoA *scene, const SceneTextureLayout *layout, int first, int count, float *texture);
+// Liste des sphères émissives, retourne leur nombre
+int packLightTexels(const SceneSoA *scene, const SceneTextureLayout *layout, float *texture);
+
+#endif // SCENE_SOA_H
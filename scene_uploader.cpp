@@ -0,0 +1,184 @@
+#include "scene_uploader.h"
+#include "rlgl.h"
+
+static const DirtyRange cleanRange = { 1, 0 };
+
+static void extendRange(DirtyRange *range, int first, int count, int size) {
+    if (count <= 0) return;
+    int last = first + count - 1;
+    if (first < 0) first = 0;
+    if (last > size - 1) last = size - 1;
+    if (first > last) return;
+    if (range->first > range->last) {
+        range->first = first;
+        range->last = last;
+    } else {
+        if (first < range->first) range->first = first;
+        if (last > range->last) range->last = last;
+    }
+}
+
+bool loadSceneUploader(SceneUploader *uploader, Shader shader, const SceneSoA *scene) {
+    uploader->shader = shader;
+    uploader->sphereCount = scene->sphereCount;
+    uploader->blockCount = scene->blockCount;
+    uploader->triangleCount = scene->triangleCount;
+    uploader->lightCount = 0;
+
+    uploader->layout = getSceneTextureLayout(scene);
+    uploader->texels.assign(4*uploader->layout.width*uploader->layout.height, 0.0f);
+    uploader->emissive.assign(scene->sphereCount, 0);
+
+    Texture2D texture = { 0 };
+    texture.id = rlLoadTexture(uploader->texels.data(), uploader->layout.width, uploader->layout.height,
+                               PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, 1);
+    texture.width = uploader->layout.width;
+    texture.height = uploader->layout.height;
+    texture.mipmaps = 1;
+    texture.format = PIXELFORMAT_UNCOMPRESSED_R32G32B32A32;
+    uploader->texture = texture;
+    if (texture.id == 0) {
+        TraceLog(LOG_ERROR, "SCENE: texture de scene %dx%d impossible", texture.width, texture.height);
+        return false;
+    }
+    SetTextureFilter(uploader->texture, TEXTURE_FILTER_POINT);
+
+    uploader->textureLoc = GetShaderLocation(shader, "sceneTexture");
+    uploader->sphereCountLoc = GetShaderLocation(shader, "sphereCount");
+    uploader->blockCountLoc = GetShaderLocation(shader, "blockCount");
+    uploader->triangleCountLoc = GetShaderLocation(shader, "triangleCount");
+    uploader->lightCountLoc = GetShaderLocation(shader, "lightCount");
+    uploader->blockOffsetLoc = GetShaderLocation(shader, "sceneBlockOffset");
+    uploader->triangleOffsetLoc = GetShaderLocation(shader, "sceneTriangleOffset");
+    uploader->lightOffsetLoc = GetShaderLocation(shader, "sceneLightOffset");
+    uploader->lightPosLoc = GetShaderLocation(shader, "lightPos");
+    uploader->lightColorLoc = GetShaderLocation(shader, "lightColor");
+    uploader->lightIntensityLoc = GetShaderLocation(shader, "lightIntensity");
+
+    // Les compteurs et la disposition ne changent pas tant que la scène n'est pas réallouée
+    SetShaderValue(shader, uploader->sphereCountLoc, &uploader->sphereCount, SHADER_UNIFORM_INT);
+    SetShaderValue(shader, uploader->blockCountLoc, &uploader->blockCount, SHADER_UNIFORM_INT);
+    SetShaderValue(shader, uploader->triangleCountLoc, &uploader->triangleCount, SHADER_UNIFORM_INT);
+    SetShaderValue(shader, uploader->blockOffsetLoc, &uploader->layout.blockOffset, SHADER_UNIFORM_INT);
+    SetShaderValue(shader, uploader->triangleOffsetLoc, &uploader->layout.triangleOffset, SHADER_UNIFORM_INT);
+    SetShaderValue(shader, uploader->lightOffsetLoc, &uploader->layout.lightOffset, SHADER_UNIFORM_INT);
+
+    uploader->lightPos = (Vector3){ 0.0f, 0.0f, 0.0f };
+    uploader->lightColor = (Vector3){ 0.0f, 0.0f, 0.0f };
+    uploader->lightIntensity = 0.0f;
+    uploader->uploadCount = 0;
+    markSceneDirty(uploader);
+    return true;
+}
+
+void unloadSceneUploader(SceneUploader *uploader) {
+    if (uploader->texture.id != 0) UnloadTexture(uploader->texture);
+    uploader->texture.id = 0;
+    uploader->texels.clear();
+    uploader->emissive.clear();
+}
+
+void markSpheresDirty(SceneUploader *uploader, int first, int count) {
+    extendRange(&uploader->spheres, first, count, uploader->sphereCount);
+}
+
+void markBlocksDirty(SceneUploader *uploader, int first, int count) {
+    extendRange(&uploader->blocks, first, count, uploader->blockCount);
+}
+
+void markTrianglesDirty(SceneUploader *uploader, int first, int count) {
+    extendRange(&uploader->triangles, first, count, uploader->triangleCount);
+}
+
+void markSceneDirty(SceneUploader *uploader) {
+    uploader->spheres = uploader->blocks = uploader->triangles = cleanRange;
+    markSpheresDirty(uploader, 0, uploader->sphereCount);
+    markBlocksDirty(uploader, 0, uploader->blockCount);
+    markTrianglesDirty(uploader, 0, uploader->triangleCount);
+    uploader->lightDirty = true;
+    uploader->lightListDirty = true;
+}
+
+static bool sameVector3(Vector3 a, Vector3 b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+void setSceneLight(SceneUploader *uploader, Vector3 position, Vector3 color, float intensity) {
+    if (sameVector3(position, uploader->lightPos) && sameVector3(color, uploader->lightColor)
+        && intensity == uploader->lightIntensity) return;
+    uploader->lightPos = position;
+    uploader->lightColor = color;
+    uploader->lightIntensity = intensity;
+    uploader->lightDirty = true;
+}
+
+// Renvoie les lignes complètes couvrant les texels [firstTexel, lastTexel]
+static void updateTexelRows(SceneUploader *uploader, int firstTexel, int lastTexel) {
+    if (lastTexel < firstTexel) return;
+    int width = uploader->layout.width;
+    int firstRow = firstTexel / width;
+    int rows = lastTexel / width - firstRow + 1;
+    rlUpdateTexture(uploader->texture.id, 0, firstRow, width, rows, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32,
+                    uploader->texels.data() + 4*width*firstRow);
+}
+
+void uploadScene(SceneUploader *uploader, const SceneSoA *scene) {
+    int uploads = 0;
+    Shader shader = uploader->shader;
+    const SceneTextureLayout *layout = &uploader->layout;
+
+    DirtyRange r = uploader->spheres;
+    if (r.first <= r.last) {
+        int count = r.last - r.first + 1;
+        packSphereTexels(scene, r.first, count, uploader->texels.data());
+        updateTexelRows(uploader, SCENE_SPHERE_TEXELS*r.first, SCENE_SPHERE_TEXELS*(r.last + 1) - 1);
+        uploads++;
+
+        // La liste des lumières n'est reconstruite que si une sphère change de type émissif
+        for (int i = r.first; i <= r.last; i++) {
+            unsigned char isEmissive = scene->sphereMaterials.type[i] == MAT_EMISSIVE;
+            if (isEmissive != uploader->emissive[i]) uploader->lightListDirty = true;
+            uploader->emissive[i] = isEmissive;
+        }
+    }
+    if (uploader->lightListDirty) {
+        uploader->lightCount = packLightTexels(scene, layout, uploader->texels.data());
+        updateTexelRows(uploader, layout->lightOffset, layout->texelCount - 1);
+        SetShaderValue(shader, uploader->lightCountLoc, &uploader->lightCount, SHADER_UNIFORM_INT);
+        uploads += 2;
+    }
+
+    r = uploader->blocks;
+    if (r.first <= r.last) {
+        int count = r.last - r.first + 1;
+        packBlockTexels(scene, layout, r.first, count, uploader->texels.data());
+        updateTexelRows(uploader, layout->blockOffset + SCENE_BLOCK_TEXELS*r.first,
+                        layout->blockOffset + SCENE_BLOCK_TEXELS*(r.last + 1) - 1);
+        uploads++;
+    }
+
+    r = uploader->triangles;
+    if (r.first <= r.last) {
+        int count = r.last - r.first + 1;
+        packTriangleTexels(scene, layout, r.first, count, uploader->texels.data());
+        updateTexelRows(uploader, layout->triangleOffset + SCENE_TRIANGLE_TEXELS*r.first,
+                        layout->triangleOffset + SCENE_TRIANGLE_TEXELS*(r.last + 1) - 1);
+        uploads++;
+    }
+
+    if (uploader->lightDirty) {
+        SetShaderValue(shader, uploader->lightPosLoc, &uploader->lightPos, SHADER_UNIFORM_VEC3);
+        SetShaderValue(shader, uploader->lightColorLoc, &uploader->lightColor, SHADER_UNIFORM_VEC3);
+        SetShaderValue(shader, uploader->lightIntensityLoc, &uploader->lightIntensity, SHADER_UNIFORM_FLOAT);
+        uploads += 3;
+    }
+
+    uploader->spheres = uploader->blocks = uploader->triangles = cleanRange;
+    uploader->lightDirty = false;
+    uploader->lightListDirty = false;
+    uploader->uploadCount = uploads;
+}
+
+void bindSceneTexture(const SceneUploader *uploader) {
+    SetShaderValueTexture(uploader->shader, uploader->textureLoc, uploader->texture);
+}
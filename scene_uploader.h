@@ -0,0 +1,66 @@
+#ifndef SCENE_UPLOADER_H
+#define SCENE_UPLOADER_H
+
+#include "raylib.h"
+#include "scene_soa.h"
+#include <vector>
+
+// Envoi de la scène SoA à raytest.fs : les sphères, les blocs, les triangles, leurs matériaux et la
+// liste des sphères émissives vivent dans une texture RGBA32F (disposition dans
+// scene_soa.h), ce qui supprime les tableaux d'uniformes de taille fixe.
+// Une copie CPU de la texture est tenue à jour ; chaque frame, seules les plages
+// marquées modifiées sont reconstruites et seules les lignes touchées sont renvoyées.
+
+// Plage d'indices modifiés, vide si first > last
+typedef struct {
+    int first;
+    int last;
+} DirtyRange;
+
+typedef struct {
+    Shader shader;
+    int sphereCount;
+    int blockCount;
+    int triangleCount;
+    int lightCount;
+
+    SceneTextureLayout layout;
+    Texture2D texture;
+    std::vector<float> texels;          // copie CPU de la texture
+    std::vector<unsigned char> emissive; // type émissif par sphère (reconstruction de la liste des lumières)
+
+    int textureLoc;
+    int sphereCountLoc, blockCountLoc, triangleCountLoc, lightCountLoc;
+    int blockOffsetLoc, triangleOffsetLoc, lightOffsetLoc;
+    int lightPosLoc, lightColorLoc, lightIntensityLoc;
+
+    DirtyRange spheres, blocks, triangles;
+    bool lightDirty;
+    bool lightListDirty;            // liste des sphères émissives à reconstruire
+    Vector3 lightPos, lightColor;   // dernières valeurs envoyées
+    float lightIntensity;
+
+    int uploadCount;    // envois (lignes de texture + uniformes) de la dernière frame
+} SceneUploader;
+
+// Crée la texture pour la taille de la scène et marque tout à envoyer ;
+// à rappeler si le nombre de sphères, de blocs ou de triangles change
+bool loadSceneUploader(SceneUploader *uploader, Shader shader, const SceneSoA *scene);
+void unloadSceneUploader(SceneUploader *uploader);
+
+// Marquage des éléments modifiés dans la SoA depuis le dernier envoi (géométrie ou matériau)
+void markSpheresDirty(SceneUploader *uploader, int first, int count);
+void markBlocksDirty(SceneUploader *uploader, int first, int count);
+void markTrianglesDirty(SceneUploader *uploader, int first, int count);
+void markSceneDirty(SceneUploader *uploader);
+
+// La lumière est comparée aux dernières valeurs envoyées, pas besoin de la marquer
+void setSceneLight(SceneUploader *uploader, Vector3 position, Vector3 color, float intensity);
+
+// Envoie les plages modifiées puis les vide
+void uploadScene(SceneUploader *uploader, const SceneSoA *scene);
+
+// Lie la texture de scène : à appeler après BeginShaderMode
+void bindSceneTexture(const SceneUploader *uploader);
+
+#endif // SCENE_UPLOADER_H
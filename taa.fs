@@ -3,16 +3,39 @@
 in vec2 fragTexCoord;
 out vec4 fragColor;
 
-uniform sampler2D currentFrame;  // denoiseTarget
-uniform sampler2D historyFrame;  // renderHistory
+uniform sampler2D currentFrame;  // sortie du débruiteur
+uniform sampler2D historyFrame;  // renderHistory reprojeté (reproject.fs), alpha 1 = pixel découvert
 
-uniform vec2 resolution;
+uniform vec2 resolution;         // résolution interne de currentFrame
+uniform vec2 outputResolution;   // résolution de la sortie et de l'historique (fenêtre)
+uniform vec2 jitter;             // position des échantillons de la frame par rapport aux centres
+                                 // des texels de currentFrame, en pixels internes (-0.5 à 0.5)
 uniform float time;
 uniform int frame;
 
+// Suréchantillonnage temporel (TAAU) : la frame courante, plus petite que la sortie, est
+// reconstruite à la position du pixel de sortie depuis ses échantillons décalés de jitter.
+// Plus l'échantillon le plus proche est loin du pixel de sortie (en pixels de sortie),
+// moins la frame courante compte face à l'historique ; le jitter qui varie d'une frame
+// à l'autre fait passer un échantillon près de chaque pixel de sortie.
+
+// Entrées en radiance linéaire HDR : le TAA travaille sur c / (1 + luminance), réversible,
+// pour que les pics isolés ne dominent ni le mélange ni les bornes du voisinage
+float luminance(vec3 c) {
+    return dot(c, vec3(0.2126, 0.7152, 0.0722));
+}
+
+vec3 compressHdr(vec3 c) {
+    c = max(c, vec3(0.0));
+    return c / (1.0 + luminance(c));
+}
+
+vec3 expandHdr(vec3 c) {
+    return c / max(1.0 - luminance(c), 1e-4);
+}
+
 // YUV-RGB conversion routine
 vec3 encodePalYuv(vec3 rgb) {
-    rgb = pow(rgb, vec3(2.0)); // gamma correction
     return vec3(
         dot(rgb, vec3(0.299, 0.587, 0.114)),
         dot(rgb, vec3(-0.14713, -0.28886, 0.436)),
@@ -26,18 +49,76 @@ vec3 decodePalYuv(vec3 yuv) {
         dot(yuv, vec3(1.0, -0.39465, -0.58060)),
         dot(yuv, vec3(1.0, 2.03211, 0.0))
     );
-    return pow(rgb, vec3(1.0 / 2.0)); // inverse gamma correction
+    return rgb;
 }
 
 void main() {
     vec2 uv = fragTexCoord;
-    vec2 off = 1.0 / resolution;
+    // Pixel de sortie dans l'espace des texels de currentFrame, échantillons aux centres + jitter
+    vec2 inputPos = uv * resolution - jitter;
+    ivec2 maxTexel = ivec2(resolution) - 1;
+
+    // Voisinage 3x3 autour du texel le plus proche ; alpha 0 = pixel sans échantillon cette
+    // frame (budget fractionnaire de raytest.fs sans débruitage pour combler les trous)
+    ivec2 nearest = ivec2(floor(inputPos));
+    const ivec2 offsets[9] = ivec2[](ivec2(0, 0), ivec2(+1, 0), ivec2(-1, 0), ivec2(0, +1), ivec2(0, -1),
+                                     ivec2(+1, +1), ivec2(-1, +1), ivec2(+1, -1), ivec2(-1, -1));
+    vec3 samples[9];
+    bool sampled[9];
+    vec3 neighbourSum = vec3(0.0);
+    float neighbourCount = 0.0;
+    for (int i = 0; i < 9; ++i) {
+        vec4 c = texelFetch(currentFrame, clamp(nearest + offsets[i], ivec2(0), maxTexel), 0);
+        samples[i] = compressHdr(c.rgb);
+        sampled[i] = c.a > 0.0;
+        if (sampled[i]) {
+            neighbourSum += samples[i];
+            neighbourCount += 1.0;
+        }
+    }
+
+    // Interpolation bilinéaire des 2x2 échantillons entourant le pixel de sortie, limitée aux
+    // texels échantillonnés (identique à texture() à résolution égale sans trous ni jitter)
+    vec2 cornerPos = inputPos - 0.5;
+    ivec2 corner = ivec2(floor(cornerPos));
+    vec2 f = cornerPos - vec2(corner);
+    vec3 reconstructed = vec3(0.0);
+    float reconstructedWeight = 0.0;
+    float nearestDistance2 = 1e4;   // carré de la distance à l'échantillon valide le plus proche
+    for (int j = 0; j < 2; ++j) {
+        for (int i = 0; i < 2; ++i) {
+            vec4 c = texelFetch(currentFrame, clamp(corner + ivec2(i, j), ivec2(0), maxTexel), 0);
+            if (c.a <= 0.0) continue;
+            float w = (i == 0 ? 1.0 - f.x : f.x) * (j == 0 ? 1.0 - f.y : f.y);
+            reconstructed += compressHdr(c.rgb) * w;
+            reconstructedWeight += w;
+            vec2 d = (vec2(i, j) - f) * outputResolution / resolution;
+            nearestDistance2 = min(nearestDistance2, dot(d, d));
+        }
+    }
+    // 1 quand un échantillon tombe sur le pixel de sortie, ~0.3 à un demi-pixel de sortie
+    float confidence = exp(-2.29 * nearestDistance2);
 
-    vec3 curr = texture(currentFrame, uv).rgb;
     vec4 histData = texture(historyFrame, uv);
+    vec3 hist = compressHdr(histData.rgb);
+
+    vec3 curr;
+    if (reconstructedWeight > 0.0) {
+        curr = reconstructed / reconstructedWeight;
+    } else {
+        // Trou : moyenne des voisins échantillonnés, sinon l'historique tel quel
+        curr = (neighbourCount > 0.0) ? neighbourSum / neighbourCount : (histData.a < 1.0 ? hist : vec3(0.0));
+        confidence = (neighbourCount > 0.0) ? 0.1 : 0.0;
+    }
 
-    vec3 hist = histData.rgb;
     float histMixRate = min(histData.a, 0.5); // lire alpha de l’historique
+    float blendRate = histMixRate * max(confidence, 0.1);
+    if (histData.a >= 1.0) {
+        // Historique rejeté : l'accumulation repart de la frame courante (1/2, 1/3, ...)
+        hist = curr;
+        histMixRate = 1.0;
+        blendRate = 1.0;
+    }
 
     //nettoyage de l’historique
     // Réinitialisation locale si trop de changement (anti-taches persistantes)
@@ -47,29 +128,16 @@ void main() {
     //}
     //hist *= 0.8;
 
-    // Gamma-space accumulation
-    vec3 blended = mix(hist * hist, curr * curr, histMixRate);
-    blended = sqrt(blended);
-
-    // Neighborhood samples
-    vec3 samples[9];
-    samples[0] = texture(currentFrame, uv).rgb;
-    samples[1] = texture(currentFrame, uv + vec2(+off.x, 0.0)).rgb;
-    samples[2] = texture(currentFrame, uv + vec2(-off.x, 0.0)).rgb;
-    samples[3] = texture(currentFrame, uv + vec2(0.0, +off.y)).rgb;
-    samples[4] = texture(currentFrame, uv + vec2(0.0, -off.y)).rgb;
-    samples[5] = texture(currentFrame, uv + vec2(+off.x, +off.y)).rgb;
-    samples[6] = texture(currentFrame, uv + vec2(-off.x, +off.y)).rgb;
-    samples[7] = texture(currentFrame, uv + vec2(+off.x, -off.y)).rgb;
-    samples[8] = texture(currentFrame, uv + vec2(-off.x, -off.y)).rgb;
-
-    // Convert to YUV for clamping
+    // Accumulation dans l'espace compressé
+    vec3 blended = mix(hist, curr, blendRate);
+    // Convert to YUV for clamping (voisins échantillonnés seulement)
     vec3 blendedYUV = encodePalYuv(blended);
 
-    vec3 minYUV = encodePalYuv(samples[0]);
+    vec3 minYUV = encodePalYuv(curr);
     vec3 maxYUV = minYUV;
 
-    for (int i = 1; i < 9; ++i) {
+    for (int i = 0; i < 9; ++i) {
+        if (!sampled[i]) continue;
         vec3 yuv = encodePalYuv(samples[i]);
         minYUV = min(minYUV, yuv);
         maxYUV = max(maxYUV, yuv);
@@ -95,6 +163,6 @@ void main() {
     mixRate += clampAmount * 4.0;
     mixRate = clamp(mixRate, 0.05, 0.5);
 
-    vec3 finalColor = decodePalYuv(blendedYUV);
+    vec3 finalColor = expandHdr(decodePalYuv(blendedYUV));
     fragColor = vec4(finalColor, mixRate); // output mixRate in alpha for next frame
 }
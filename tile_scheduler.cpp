@@ -0,0 +1,147 @@
+#include "tile_scheduler.h"
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// File de tuiles d'un thread. Un simple mutex suffit : une tuile coûte des
+// millisecondes, la contention sur la file est négligeable.
+typedef struct {
+    std::mutex lock;
+    std::deque<int> tiles;
+} TileQueue;
+
+typedef struct {
+    const std::vector<Tile> *tiles;
+    std::vector<TileQueue> *queues;
+    TileRenderFunc render;
+    void *userData;
+    std::vector<TileTiming> *timings;
+} TileJob;
+
+static bool popOwn(TileQueue *queue, int *tileIndex) {
+    std::lock_guard<std::mutex> guard(queue->lock);
+    if (queue->tiles.empty()) return false;
+    *tileIndex = queue->tiles.back();
+    queue->tiles.pop_back();
+    return true;
+}
+
+static bool steal(TileQueue *queue, int *tileIndex) {
+    std::lock_guard<std::mutex> guard(queue->lock);
+    if (queue->tiles.empty()) return false;
+    *tileIndex = queue->tiles.front();
+    queue->tiles.pop_front();
+    return true;
+}
+
+static void tileWorker(TileJob *job, int threadIndex) {
+    std::vector<TileQueue> &queues = *job->queues;
+    int queueCount = (int)queues.size();
+    unsigned int victimSeed = 2654435761u * (unsigned int)(threadIndex + 1);
+
+    for (;;) {
+        int tileIndex;
+        bool stolen = false;
+        if (!popOwn(&queues[threadIndex], &tileIndex)) {
+            // File vide : on essaie les autres threads en partant d'une victime pseudo-aléatoire
+            victimSeed = victimSeed * 1664525u + 1013904223u;
+            int start = (int)(victimSeed >> 8) % queueCount;
+            for (int k = 0; k < queueCount && !stolen; k++) {
+                int victim = (start + k) % queueCount;
+                if (victim != threadIndex) stolen = steal(&queues[victim], &tileIndex);
+            }
+            // Les tuiles ne sont jamais ré-ajoutées : toutes les files vides = travail terminé
+            if (!stolen) return;
+        }
+
+        const Tile &tile = (*job->tiles)[tileIndex];
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        job->render(&tile, job->userData);
+        if (job->timings != NULL) {
+            TileTiming &timing = (*job->timings)[tileIndex];
+            timing.tile = tile;
+            timing.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            timing.thread = threadIndex;
+            timing.stolen = stolen;
+        }
+    }
+}
+
+void runTiles(int width, int height, int tileSize, int threadCount, TileRenderFunc render, void *userData, std::vector<TileTiming> *timings) {
+    tileSize = std::max(TILE_SIZE_MIN, std::min(TILE_SIZE_MAX, tileSize));
+    if (threadCount <= 0) threadCount = (int)std::thread::hardware_concurrency();
+    if (threadCount <= 0) threadCount = 1;
+
+    std::vector<Tile> tiles;
+    for (int y = 0; y < height; y += tileSize) {
+        for (int x = 0; x < width; x += tileSize) {
+            Tile tile = { x, y, std::min(tileSize, width - x), std::min(tileSize, height - y) };
+            tiles.push_back(tile);
+        }
+    }
+    if (tiles.empty()) return;
+    if (threadCount > (int)tiles.size()) threadCount = (int)tiles.size();
+
+    // Répartition initiale en blocs contigus (ordre de balayage) : un thread tombé sur
+    // une zone de ciel finit vite et vole les tuiles coûteuses (miroir, verre) des autres
+    std::vector<TileQueue> queues(threadCount);
+    int tileCount = (int)tiles.size();
+    for (int t = 0; t < threadCount; t++) {
+        int begin = (int)((long long)tileCount * t / threadCount);
+        int end = (int)((long long)tileCount * (t + 1) / threadCount);
+        // L'arrière de la file est traité en premier par son propriétaire, les voleurs prennent l'avant
+        for (int i = end - 1; i >= begin; i--) queues[t].tiles.push_back(i);
+    }
+
+    if (timings != NULL) timings->assign(tiles.size(), TileTiming());
+
+    TileJob job = { &tiles, &queues, render, userData, timings };
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threadCount; t++) workers.push_back(std::thread(tileWorker, &job, t));
+    tileWorker(&job, 0);
+    for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+}
+
+void printTileStats(const std::vector<TileTiming> &timings) {
+    if (timings.empty()) return;
+    int threadCount = 1;
+    for (size_t i = 0; i < timings.size(); i++) threadCount = std::max(threadCount, timings[i].thread + 1);
+
+    double minMs = 1e30, maxMs = 0.0, sumMs = 0.0;
+    std::vector<double> busy(threadCount, 0.0);
+    std::vector<int> tileCounts(threadCount, 0), steals(threadCount, 0);
+    for (size_t i = 0; i < timings.size(); i++) {
+        const TileTiming &t = timings[i];
+        minMs = std::min(minMs, t.ms);
+        maxMs = std::max(maxMs, t.ms);
+        sumMs += t.ms;
+        busy[t.thread] += t.ms;
+        tileCounts[t.thread]++;
+        if (t.stolen) steals[t.thread]++;
+    }
+
+    double maxBusy = *std::max_element(busy.begin(), busy.end());
+    double avgBusy = sumMs / threadCount;
+    printf("Tuiles : %d, min %.2f ms, moyenne %.2f ms, max %.2f ms\n", (int)timings.size(), minMs, sumMs / timings.size(), maxMs);
+    printf("Desequilibre (thread le plus charge / moyenne) : %.2f\n", avgBusy > 0.0 ? maxBusy / avgBusy : 1.0);
+    for (int t = 0; t < threadCount; t++) {
+        if (tileCounts[t] == 0) continue;
+        printf("  thread %2d : %4d tuiles (%3d volees), %.1f ms\n", t, tileCounts[t], steals[t], busy[t]);
+    }
+}
+
+bool saveTileStatsCSV(const char *fileName, const std::vector<TileTiming> &timings) {
+    FILE *file = fopen(fileName, "w");
+    if (file == NULL) return false;
+
+    fprintf(file, "x,y,width,height,ms,thread,stolen\n");
+    for (size_t i = 0; i < timings.size(); i++) {
+        const TileTiming &t = timings[i];
+        fprintf(file, "%d,%d,%d,%d,%.4f,%d,%d\n", t.tile.x, t.tile.y, t.tile.width, t.tile.height, t.ms, t.thread, t.stolen ? 1 : 0);
+    }
+    fclose(file);
+    return true;
+}
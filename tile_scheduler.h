@@ -0,0 +1,38 @@
+#ifndef TILE_SCHEDULER_H
+#define TILE_SCHEDULER_H
+
+#include <vector>
+
+// Découpage de l'image en tuiles et répartition sur un pool de threads avec vol de
+// travail : chaque thread a sa propre file (deque), traite ses tuiles depuis l'arrière
+// et vole par l'avant chez les autres quand la sienne est vide.
+
+#define TILE_SIZE_MIN 16
+#define TILE_SIZE_MAX 64
+#define TILE_SIZE_DEFAULT 32
+
+typedef struct {
+    int x, y;           // coin haut gauche en pixels (ligne 0 = haut de l'image)
+    int width, height;  // plus petites au bord droit / bas
+} Tile;
+
+// Mesure par tuile pour visualiser le déséquilibre de charge
+typedef struct {
+    Tile tile;
+    double ms;          // temps de rendu de la tuile
+    int thread;         // thread qui l'a rendue
+    bool stolen;        // tuile volée dans la file d'un autre thread
+} TileTiming;
+
+typedef void (*TileRenderFunc)(const Tile *tile, void *userData);
+
+// Rend toutes les tuiles de l'image width x height. threadCount <= 0 = tous les coeurs.
+// Si timings n'est pas NULL il reçoit une entrée par tuile.
+void runTiles(int width, int height, int tileSize, int threadCount, TileRenderFunc render, void *userData, std::vector<TileTiming> *timings);
+
+// Résumé texte : temps min/moyen/max par tuile, occupation et vols par thread
+void printTileStats(const std::vector<TileTiming> &timings);
+// Une ligne CSV par tuile : x,y,largeur,hauteur,ms,thread,volee
+bool saveTileStatsCSV(const char *fileName, const std::vector<TileTiming> &timings);
+
+#endif // TILE_SCHEDULER_H
@@ -0,0 +1,28 @@
+#version 330 core
+
+in vec2 fragTexCoord;
+out vec4 fragColor;
+
+// Passe finale : la chaîne (raytracing, débruitage, TAA) travaille en radiance
+// linéaire RGBA16F ; tone mapping, gamma et vignette ne s'appliquent qu'ici.
+uniform sampler2D texture0;     // sortie du TAA (alpha = taux de mélange, ignoré)
+
+void main() {
+    vec3 color = max(texture(texture0, fragTexCoord).rgb, vec3(0.0));
+
+    // Tone mapping (ACES)
+    const float a = 2.51;
+    const float b = 0.03;
+    const float c = 2.43;
+    const float d = 0.59;
+    const float e = 0.14;
+    color = clamp((color * (a * color + b)) / (color * (c * color + d) + e), 0.0, 1.0);
+
+    // Correction gamma
+    color = pow(color, vec3(1.0 / 2.2));
+
+    // Légère vignette
+    vec2 q = fragTexCoord;
+    color *= 0.7 + 0.3 * pow(16.0 * q.x * q.y * (1.0 - q.x) * (1.0 - q.y), 0.1);
+    fragColor = vec4(color, 1.0);
+}